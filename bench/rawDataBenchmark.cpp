@@ -0,0 +1,88 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <actor/link.h>
+#include <actor/rawData.h>
+#include <actor/commandMap.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+
+/*
+ * Counts the heap allocations and measures the time needed to build a payload, post it on a link
+ * and get it back, for several payload sizes.
+ */
+
+static std::atomic<size_t> nbAllocations(0);
+
+void *operator new(size_t size) {
+	nbAllocations++;
+	if (void * const p = malloc(size))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+static const Command BENCH_COMMAND = 0x01 | COMMAND_FLAG;
+
+static void postAndGet(unsigned int nbMessages, size_t payloadSize) {
+	const auto link = Link::create("bench");
+	const std::string bytes(payloadSize, 'a');
+	/* the first messages fill the node pool of the thread. */
+	for (unsigned int i = 0; i < 1024; i++)
+		link->post(BENCH_COMMAND, RawData(bytes));
+	for (unsigned int i = 0; i < 1024; i++)
+		link->get();
+
+	const auto firstAllocation = nbAllocations.load();
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned int i = 0; i < nbMessages; i++) {
+		link->post(BENCH_COMMAND, (sizeof(uint32_t) == payloadSize) ? RawData(i) : RawData(bytes));
+		link->get();
+	}
+	const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+	std::cout << payloadSize << " bytes: " << static_cast<double>(nbAllocations - firstAllocation) / nbMessages
+				<< " allocations and " << elapsed.count() / nbMessages << " ns per message" << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+	const unsigned int nbMessages = (1 < argc) ? std::strtoul(argv[1], NULL, 10) : 1000000;
+
+	for (const size_t size : { sizeof(uint32_t), static_cast<size_t>(16), RawData::INLINE_CAPACITY,
+								RawData::INLINE_CAPACITY + 1, static_cast<size_t>(1024) })
+		postAndGet(nbMessages, size);
+	return EXIT_SUCCESS;
+}
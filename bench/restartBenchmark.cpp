@@ -0,0 +1,80 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <actor/actor.h>
+#include <actor/commandMap.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+/*
+ * Measures the time between a failing command and the end of the atRestart hook of the actor
+ * restarted by its supervisor.
+ */
+
+static const Command FAILING_COMMAND = 0x01 | COMMAND_FLAG;
+
+static double restartLatencyInMicroseconds(unsigned int nbRestarts, const ActorOptions &options) {
+	std::atomic<unsigned int> nbRestarted(0);
+	const ActorHooks hooks(DEFAULT_START_HOOK, DEFAULT_STOP_HOOK, [&nbRestarted](const Context &) {
+		nbRestarted++;
+		return StatusCode::OK;
+	});
+	commandMap commands[] = {
+		{ FAILING_COMMAND, [](Context &, const RawData &, const SharedSenderLink &) -> StatusCode {
+			throw std::runtime_error("failure");
+		}},
+		{ 0, NULL },
+	};
+	Actor supervisor("supervisor", CommandExecutor(), options);
+	Actor supervised("supervised", commands, hooks, std::make_unique<NoState>(), DEFAULT_ERROR_DISPATCHER, options);
+	supervisor.registerActor(supervised);
+
+	const auto start = std::chrono::steady_clock::now();
+	for (unsigned int i = 1; i <= nbRestarts; i++) {
+		supervised.post(FAILING_COMMAND);
+		while (nbRestarted < i)
+			std::this_thread::yield();
+	}
+	const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+	return elapsed.count() / nbRestarts;
+}
+
+int main(int argc, char *argv[]) {
+	const unsigned int nbRestarts = (1 < argc) ? std::strtoul(argv[1], NULL, 10) : 10000;
+
+	std::cout << "thread per actor: " << restartLatencyInMicroseconds(nbRestarts, ActorOptions())
+				<< " us per restart" << std::endl;
+	std::cout << "scheduler: " << restartLatencyInMicroseconds(nbRestarts, ActorOptions(Scheduler::create(2)))
+				<< " us per restart" << std::endl;
+	return EXIT_SUCCESS;
+}
@@ -33,16 +33,25 @@
 #include <actor/errorActionDispatcher.h>
 #include <actor/context.h>
 #include <actor/commandExecutor.h>
+#include <actor/actorOptions.h>
+#include <actor/io.h>
 
 #include <functional>
+#include <initializer_list>
+#include <vector>
+#include <memory>
 
 using AtStopHook = std::function<void(const Context &)>;
 using AtStartHook = std::function<StatusCode(const Context &)>;
 using AtRestartHook = std::function<StatusCode(const Context &)>;
+using AtHibernateHook = std::function<void(const Context &)>;
+using AtWakeHook = std::function<void(const Context &)>;
 
 extern const AtStartHook DEFAULT_START_HOOK;
 extern const AtStopHook DEFAULT_STOP_HOOK;
 extern const AtRestartHook DEFAULT_RESTART_HOOK;
+extern const AtHibernateHook DEFAULT_HIBERNATE_HOOK;
+extern const AtWakeHook DEFAULT_WAKE_HOOK;
 extern const ErrorActionDispatcher DEFAULT_ERROR_DISPATCHER;
 
 
@@ -56,10 +65,26 @@ struct ActorHooks {
 	AtStartHook atStart;
 	AtStopHook atStop;
 	AtRestartHook atRestart;
-	ActorHooks(AtStartHook atStart, AtStopHook atStop, AtRestartHook atRestart) :
-									atStart(atStart), atStop(atStop), atRestart(atRestart) { }
+	/* see ActorOptions::idleTimeout. */
+	AtHibernateHook atHibernate;
+	AtWakeHook atWake;
+	ActorHooks(AtStartHook atStart, AtStopHook atStop, AtRestartHook atRestart,
+				AtHibernateHook atHibernate = DEFAULT_HIBERNATE_HOOK, AtWakeHook atWake = DEFAULT_WAKE_HOOK) :
+									atStart(atStart), atStop(atStop), atRestart(atRestart),
+									atHibernate(atHibernate), atWake(atWake) { }
 };
 
+struct ShutdownReport {
+	size_t nbStopped;
+	/* names of the actors still running at the deadline. */
+	std::vector<std::string> stragglers;
+	ShutdownReport() : nbStopped(0) { }
+};
+
+class Actor;
+/* called concurrently by Actor::spawnAll(): the actor must be created with the options given. */
+using ActorFactory = std::function<std::unique_ptr<Actor>(size_t index, const ActorOptions &options)>;
+
 class Actor : public SharableSenderApi {
 public:
 	Actor(std::string name, CommandExecutor commandExecutor = CommandExecutor(), ErrorActionDispatcher errorDispatcher = DEFAULT_ERROR_DISPATCHER);
@@ -69,6 +94,9 @@ public:
 	Actor(std::string name, CommandExecutor commandExecutor, std::unique_ptr<State> state,
 			ErrorActionDispatcher errorDispatcher = DEFAULT_ERROR_DISPATCHER);
 	Actor(std::string name, CommandExecutor commandExecutor, ActorHooks hooks, std::unique_ptr<State> state,
+			ErrorActionDispatcher errorDispatcher = DEFAULT_ERROR_DISPATCHER, ActorOptions options = ActorOptions());
+
+	Actor(std::string name, CommandExecutor commandExecutor, ActorOptions options,
 			ErrorActionDispatcher errorDispatcher = DEFAULT_ERROR_DISPATCHER);
 
 	~Actor();
@@ -78,13 +106,46 @@ public:
 
 	void post(Command command, SharedSenderLink sender = SharedSenderLink()) const;
 	void post(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink()) const;
+	void post(Command command, RawData &&params, SharedSenderLink sender = SharedSenderLink()) const;
+	/* the object is moved to the actor: see typedCommand() to handle it. */
+	template<typename T, typename = EnableIfTypedObject<T>>
+	void post(Command command, T &&object, SharedSenderLink sender = SharedSenderLink()) const {
+		post(command, typedPayload(std::forward<T>(object)), std::move(sender));
+	}
+	void post(std::initializer_list<PostedCommand> commands, SharedSenderLink sender = SharedSenderLink()) const;
+	void post(const std::vector<PostedCommand> &commands, SharedSenderLink sender = SharedSenderLink()) const;
+	PostStatus tryPost(Command command, SharedSenderLink sender = SharedSenderLink()) const;
+	PostStatus tryPost(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink()) const;
+	Reply ask(Command command, unsigned int timeout_in_ms) const;
+	Reply ask(Command command, const RawData &params, unsigned int timeout_in_ms) const;
 
 	SharedSenderLink getActorLinkRef() const override;
+	Placement getPlacement(void) const;
+	SchedulingStatistics getStatistics(void) const;
+	/* throws ActorStartFailure when atStart failed. Only useful with ActorOptions::asyncStart. */
+	void waitStarted(void) const;
+	/* see Context::watch(). */
+	void watch(int fd, uint32_t events, Command command) const;
+	void unwatch(int fd) const;
+	/*
+	 * stops this actor and every actor it supervises, directly or not, after their current command.
+	 * All of them stop in parallel: destroying them afterwards does not wait anymore.
+	 * Must not be called by one of the actors it stops.
+	 */
+	ShutdownReport shutdown(unsigned int deadline_in_ms) const;
 
 	void registerActor(Actor &monitored);
 	void unregisterActor(Actor &monitored);
 
 	static void notifyError(int e);
+	/*
+	 * creates the actors from several threads without waiting for their start, then waits until all of
+	 * them started: throws ActorStartFailure if one of them did not start.
+	 */
+	static std::vector<std::unique_ptr<Actor>> spawnAll(size_t nbActors, ActorFactory factory,
+														ActorOptions options = ActorOptions());
+	/* same as shutdown() for all the actors of the process. */
+	static ShutdownReport shutdownAll(unsigned int deadline_in_ms);
 
 private:
 	class ActorImpl;
@@ -0,0 +1,60 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef ACTOR_OPTIONS_H__
+#define ACTOR_OPTIONS_H__
+
+#include <actor/mailBoxOptions.h>
+#include <actor/scheduler.h>
+#include <actor/placement.h>
+
+struct ActorOptions {
+	MailBoxOptions mailBox;
+	/* no scheduler: the actor runs in its own thread. */
+	SharedScheduler scheduler;
+	/* CPUs the executor thread is pinned to. A pooled actor runs where the scheduler pins its workers. */
+	CpuSet cpus;
+	/* messages a pooled actor processes before letting other actors run (0: the scheduler budget). */
+	size_t messageBudget;
+	/* the constructor returns without waiting for atStart: see Actor::waitStarted(). */
+	bool asyncStart;
+	/*
+	 * in ms, 0: never. An actor running in its own thread and without message for that long ends its
+	 * thread and frees its mailbox buffer until the next message. A pooled actor owns no thread and
+	 * ignores it.
+	 */
+	unsigned int idleTimeout;
+	explicit ActorOptions(MailBoxOptions mailBox = MailBoxOptions(), SharedScheduler scheduler = SharedScheduler()) :
+								mailBox(mailBox), scheduler(std::move(scheduler)), messageBudget(0), asyncStart(false),
+								idleTimeout(0) { }
+	explicit ActorOptions(SharedScheduler scheduler, MailBoxOptions mailBox = MailBoxOptions()) :
+								ActorOptions(mailBox, std::move(scheduler)) { }
+};
+
+#endif
@@ -0,0 +1,72 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef BALANCING_POOL_H__
+#define BALANCING_POOL_H__
+
+#include <actor/actor.h>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+ * Identical actors consuming from one shared mailbox: a member only gets the next message once it
+ * is done with the previous one, so no message waits behind a slow member while another one is idle.
+ * The members are actors of their own: each of them can be supervised, restarted or stopped.
+ */
+class BalancingPool : public SharableSenderApi {
+public:
+	BalancingPool(std::string name, size_t nbMembers, CommandExecutorFactory factory,
+					ActorOptions options = ActorOptions());
+	~BalancingPool();
+
+	BalancingPool(const BalancingPool &p) = delete;
+	BalancingPool &operator=(const BalancingPool &p) = delete;
+
+	void post(Command command, SharedSenderLink sender = SharedSenderLink()) const;
+	void post(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink()) const;
+	Reply ask(Command command, unsigned int timeout_in_ms) const;
+	Reply ask(Command command, const RawData &params, unsigned int timeout_in_ms) const;
+
+	const std::string &getName(void) const;
+	SharedSenderLink getActorLinkRef() const override;
+
+	size_t getNbMembers(void) const;
+	Actor &getMember(size_t index) const;
+
+private:
+	class PoolLink;
+
+	const std::shared_ptr<PoolLink> link;
+	const std::vector<std::unique_ptr<Actor>> members;
+};
+
+#endif
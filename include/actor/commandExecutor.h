@@ -61,4 +61,7 @@ private:
 	CommandExecutorImpl *pImpl;
 };
 
+/* called concurrently by the pools of identical actors: each call builds the executor of one actor. */
+using CommandExecutorFactory = std::function<CommandExecutor(size_t index)>;
+
 #endif
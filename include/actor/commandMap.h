@@ -34,8 +34,25 @@
 #include <actor/context.h>
 #include <actor/rawData.h>
 #include <actor/senderApi.h>
+#include <actor/typedPayload.h>
 
 using CommandFunction = std::function<StatusCode(Context &, const RawData &, const SharedSenderLink &)>;
+template<typename T>
+using TypedCommandFunction = std::function<StatusCode(Context &, const T &, const SharedSenderLink &)>;
+
+/*
+ * The command gets the object posted by an actor of this process without copy. The payloads
+ * received from other processes are decoded with the PayloadCodec of T.
+ */
+template<typename T>
+CommandFunction typedCommand(TypedCommandFunction<T> command) {
+	return [command](Context &context, const RawData &data, const SharedSenderLink &sender) {
+		const auto object = payloadObject<T>(data);
+		if (nullptr != object)
+			return command(context, *object, sender);
+		return command(context, TypedValue<T>::decode(data), sender);
+	};
+}
 
 struct commandMap {
 	Command commandCode;
@@ -43,6 +60,10 @@ struct commandMap {
 };
 
 static const uint32_t UNKNOWN_COMMAND = 0x00000003;
+/* answer to a remote request that the mailbox of the actor could not accept. */
+static const uint32_t MAILBOX_FULL = 0x00000004;
+/* answer to a remote request whose reply could not be serialized. */
+static const uint32_t REPLY_NOT_SERIALIZABLE = 0x00000005;
 static const uint32_t COMMAND_FLAG = 0x80000000;
 
 #endif
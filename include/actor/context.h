@@ -32,6 +32,10 @@
 #include <actor/types.h>
 #include <actor/state.h>
 
+#include <functional>
+
+using ContinuationTask = std::function<StatusCode(void)>;
+
 class Context {
 public:
 	virtual ~Context() = default;
@@ -40,6 +44,17 @@ public:
 	virtual void restartActors() const = 0;
 	virtual void stopActors() const = 0;
 	virtual State &getState() = 0;
+	/*
+	 * returns a function that can be called from any thread to run task on the executor of the actor,
+	 * after the messages already posted. The status returned by task is handled as a command status.
+	 */
+	virtual std::function<void(void)> continuation(ContinuationTask task) const = 0;
+	/*
+	 * the actor receives command, with IoReadiness parameters, when fd becomes ready for one of the
+	 * IoEvents. The next readiness is only reported once that command returned.
+	 */
+	virtual void watch(int fd, uint32_t events, Command command) const = 0;
+	virtual void unwatch(int fd) const = 0;
 protected:
 	Context() = default;
 };
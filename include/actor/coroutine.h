@@ -0,0 +1,157 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef COROUTINE_H__
+#define COROUTINE_H__
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+
+#include <actor/commandMap.h>
+#include <actor/reply.h>
+#include <actor/timer.h>
+
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <chrono>
+#include <utility>
+
+/*
+ * Coroutine command handlers: a handler runs until its first co_await, then the executor goes on
+ * with the next messages. The handler is resumed on the executor of its actor once the awaited
+ * reply or timer is there, so it never runs concurrently with the other commands of the actor.
+ * Its co_return status is handled as the status of a synchronous command.
+ * Parameters are taken by value since the handler outlives the message.
+ */
+class CommandTask {
+public:
+	struct promise_type {
+		Context *context;
+		StatusCode status;
+		std::exception_ptr exception;
+
+		template<typename... Args>
+		promise_type(Context &context, Args &...) : context(&context), status(StatusCode::OK) { }
+		/* lambdas and member functions get their object first. */
+		template<typename Object, typename... Args>
+		promise_type(Object &, Context &context, Args &...) : context(&context), status(StatusCode::OK) { }
+
+		CommandTask get_return_object() { return CommandTask(Handle::from_promise(*this)); }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_always final_suspend() noexcept { return {}; }
+		void return_value(StatusCode s) { status = s; }
+		void unhandled_exception() { exception = std::current_exception(); }
+	};
+	using Handle = std::coroutine_handle<promise_type>;
+
+	explicit CommandTask(Handle handle) : handle(handle) { }
+	CommandTask(CommandTask &&t) : handle(std::exchange(t.handle, nullptr)) { }
+	CommandTask(const CommandTask &t) = delete;
+	CommandTask &operator=(const CommandTask &t) = delete;
+	~CommandTask() {
+		if (handle)
+			handle.destroy();
+	}
+
+	/* status of the first run: a suspended handler belongs to what it awaits from now on. */
+	StatusCode start(void) {
+		const auto h = std::exchange(handle, nullptr);
+		return h.done() ? complete(h) : StatusCode::OK;
+	}
+
+	static StatusCode complete(Handle h) {
+		const auto status = h.promise().status;
+		const auto exception = h.promise().exception;
+		h.destroy();
+		if (exception)
+			std::rethrow_exception(exception);
+		return status;
+	}
+private:
+	Handle handle;
+};
+
+/* owner of a suspended handler until it is resumed: destroys it when the actor stopped in the meantime. */
+class SuspendedCommand {
+public:
+	explicit SuspendedCommand(CommandTask::Handle handle) : handle(handle) { }
+	SuspendedCommand(const SuspendedCommand &s) = delete;
+	SuspendedCommand &operator=(const SuspendedCommand &s) = delete;
+	~SuspendedCommand() {
+		if (handle)
+			handle.destroy();
+	}
+
+	StatusCode resume(void) {
+		const auto h = std::exchange(handle, nullptr);
+		h.resume();
+		return h.done() ? CommandTask::complete(h) : StatusCode::OK;
+	}
+
+	/* called from any thread: the handler is resumed by its actor. */
+	static std::function<void(void)> resumeOnActor(CommandTask::Handle handle) {
+		const auto suspended = std::make_shared<SuspendedCommand>(handle);
+		return handle.promise().context->continuation([suspended]() { return suspended->resume(); });
+	}
+private:
+	CommandTask::Handle handle;
+};
+
+using CoroutineFunction = std::function<CommandTask(Context &, RawData, SharedSenderLink)>;
+
+static inline CommandFunction coroutineCommand(CoroutineFunction f) {
+	return [f](Context &context, const RawData &data, const SharedSenderLink &sender) {
+		return f(context, data, sender).start();
+	};
+}
+
+/* co_await on a Reply gives it back once answered or timed out: get() does not block anymore. */
+struct ReplyAwaiter {
+	Reply reply;
+
+	bool await_ready() const { return reply.isReady(); }
+	void await_suspend(CommandTask::Handle h) const { reply.then(SuspendedCommand::resumeOnActor(h)); }
+	Reply await_resume() const { return reply; }
+};
+
+static inline ReplyAwaiter operator co_await(Reply reply) { return ReplyAwaiter { std::move(reply) }; }
+
+struct SleepAwaiter {
+	std::chrono::milliseconds delay;
+
+	bool await_ready() const { return 0 >= delay.count(); }
+	void await_suspend(CommandTask::Handle h) const { runAfter(delay.count(), SuspendedCommand::resumeOnActor(h)); }
+	void await_resume() const { }
+};
+
+static inline SleepAwaiter sleepFor(std::chrono::milliseconds delay) { return SleepAwaiter { delay }; }
+
+#endif
+
+#endif
@@ -0,0 +1,185 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef FLAT_PAYLOAD_H__
+#define FLAT_PAYLOAD_H__
+
+#include <actor/rawData.h>
+#include <actor/payloadSerializer.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Payloads read in place, without parsing. A table starts with its number of fields and the offset
+ * of each field from the start of the table (0 when the field is absent), all uint32_t. Values are
+ * little endian and aligned on their size from the start of the table:
+ *	- scalars (integers, enums, floats);
+ *	- byte spans and strings: uint32_t size then the bytes;
+ *	- vectors of scalars: uint32_t count then the elements;
+ *	- nested tables: uint32_t size then the table, aligned on 8 bytes.
+ * The offsets are relative to their table: a table is nested by copying its bytes.
+ */
+class FlatEncoding {
+public:
+	template<typename T>
+	static void store(T value, uint8_t *bytes) {
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only scalars are stored.");
+		std::memcpy(bytes, &value, sizeof(value));
+		toLittleEndian(bytes, sizeof(value));
+	}
+
+	template<typename T>
+	static T load(const uint8_t *bytes) {
+		static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value, "only scalars are loaded.");
+		T value;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		uint8_t swapped[sizeof(T)];
+		std::reverse_copy(bytes, bytes + sizeof(T), swapped);
+		bytes = swapped;
+#endif
+		std::memcpy(&value, bytes, sizeof(value));
+		return value;
+	}
+private:
+	static void toLittleEndian(uint8_t *bytes, size_t size) {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		std::reverse(bytes, bytes + size);
+#else
+		(void) bytes;
+		(void) size;
+#endif
+	}
+};
+
+/* writes the table in one pass: each value is appended once, then its offset is set. */
+class FlatBuilder {
+public:
+	/* capacity: expected size of the table, to allocate its buffer once. */
+	explicit FlatBuilder(unsigned int nbFields, size_t capacity = 0);
+	~FlatBuilder();
+
+	template<typename T, typename = typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type>
+	FlatBuilder &set(unsigned int field, T value) {
+		FlatEncoding::store(value, data.data() + allocate(field, sizeof(T), sizeof(T)));
+		return *this;
+	}
+	FlatBuilder &set(unsigned int field, const std::string &value);
+	FlatBuilder &set(unsigned int field, const RawData &value);
+	FlatBuilder &set(unsigned int field, ByteSpan value);
+	template<typename T>
+	FlatBuilder &set(unsigned int field, const std::vector<T> &values) {
+		const auto alignment = (sizeof(T) < sizeof(uint32_t)) ? sizeof(uint32_t) : sizeof(T);
+		const auto offset = allocate(field, alignment + values.size() * sizeof(T), alignment) +
+																		alignment - sizeof(uint32_t);
+		FlatEncoding::store(static_cast<uint32_t>(values.size()), data.data() + offset);
+		auto element = data.data() + offset + sizeof(uint32_t);
+		for (const auto &v : values) {
+			FlatEncoding::store(v, element);
+			element += sizeof(T);
+		}
+		return *this;
+	}
+	/* table: built by another FlatBuilder. */
+	FlatBuilder &setTable(unsigned int field, const RawData &table);
+
+	/* the table: the builder is empty afterwards. */
+	RawData finish(void);
+private:
+	const unsigned int nbFields;
+	RawData data;
+
+	/* appends size bytes aligned on alignment for the field and returns their offset. */
+	size_t allocate(unsigned int field, size_t size, size_t alignment);
+	void setBytes(unsigned int field, const void *bytes, size_t size, size_t alignment);
+};
+
+template<typename T>
+class FlatVector {
+public:
+	FlatVector(const uint8_t *elements, size_t count) : elements(elements), count(count) { }
+
+	size_t size(void) const { return count; }
+	bool empty(void) const { return 0 == count; }
+	T operator[](size_t i) const { return FlatEncoding::load<T>(elements + i * sizeof(T)); }
+private:
+	const uint8_t *elements;
+	size_t count;
+};
+
+/*
+ * Reads the fields of a table in the payload: the payload must outlive the view. The offsets are
+ * checked against the size of the payload: reading a field outside of it throws std::runtime_error.
+ */
+class FlatView {
+public:
+	explicit FlatView(const RawData &data);
+	~FlatView();
+
+	unsigned int getNbFields(void) const { return nbFields; }
+	bool has(unsigned int field) const;
+
+	template<typename T>
+	T get(unsigned int field, T defaultValue = T()) const {
+		const auto offset = offsetOf(field, sizeof(T));
+		return (0 == offset) ? defaultValue : FlatEncoding::load<T>(bytes + offset);
+	}
+	/* points in the payload: empty when the field is absent. */
+	ByteSpan getBytes(unsigned int field) const;
+	std::string getString(unsigned int field) const;
+	template<typename T>
+	FlatVector<T> getVector(unsigned int field) const {
+		const auto alignment = (sizeof(T) < sizeof(uint32_t)) ? sizeof(uint32_t) : sizeof(T);
+		const auto offset = offsetOf(field, alignment);
+		if (0 == offset)
+			return FlatVector<T>(nullptr, 0);
+		const auto countOffset = offset + alignment - sizeof(uint32_t);
+		const size_t count = FlatEncoding::load<uint32_t>(bytes + countOffset);
+		checkInside(offset + alignment, count * sizeof(T));
+		return FlatVector<T>(bytes + offset + alignment, count);
+	}
+	/* a view without field when the field is absent. */
+	FlatView getTable(unsigned int field) const;
+private:
+	const uint8_t *bytes;
+	size_t size;
+	unsigned int nbFields;
+
+	FlatView(const uint8_t *bytes, size_t size);
+	/* 0 when the field is absent. */
+	size_t offsetOf(unsigned int field, size_t valueSize) const;
+	void checkInside(size_t offset, size_t valueSize) const;
+};
+
+#endif
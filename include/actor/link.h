@@ -30,9 +30,13 @@
 #ifndef LINK_H__
 #define LINK_H__
 
-#include <private/sharedQueue.h>
+#include <private/mailBox.h>
 #include <private/types.h>
 #include <actor/senderApi.h>
+#include <actor/context.h>
+
+#include <initializer_list>
+#include <vector>
 
 class Link;
 using SharedLink = std::shared_ptr<Link>;
@@ -44,7 +48,9 @@ public:
 			const Command code;
 			RawData params;
 			SharedSenderLink sender;
-			Message(MessageType type, int code, RawData params, SharedSenderLink sender);
+			/* internal message: never evicted from a DROP_OLDEST mailbox. */
+			const bool forced;
+			Message(MessageType type, int code, RawData params, SharedSenderLink sender, bool forced = false);
 			Message();
 			~Message();
 			Message(struct Message &&m);
@@ -57,20 +63,41 @@ public:
 	};
 	virtual ~Link();
 
+	using SenderApi::post;
 	void post(Command command, SharedSenderLink sender = SharedSenderLink());
 	void post(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink());
+	void post(Command command, RawData &&params, SharedSenderLink sender = SharedSenderLink()) override;
+
+	void post(std::initializer_list<PostedCommand> commands, SharedSenderLink sender = SharedSenderLink());
+	void post(const std::vector<PostedCommand> &commands, SharedSenderLink sender = SharedSenderLink());
+
+	PostStatus tryPost(Command command, SharedSenderLink sender = SharedSenderLink());
+	PostStatus tryPost(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink()) override;
 
 	void post(MessageType type, Command command, RawData params = RawData());
+	/* queued behind the commands: the task runs on the executor of the actor owning the link. */
+	void defer(ContinuationTask task);
+	/* hands over a message taken from another link: never waits for room nor gets evicted. */
+	void forcePost(Message &&message);
 
 	Message get(void);
 	Message get(unsigned int timeout_in_ms);
 
-	static SharedLink create(std::string name = std::string());
+	size_t size(void) const;
+
+	void setWakeUp(std::function<void(void)> wakeUp);
+	bool hasMessage(void) const;
+	bool trySleep(void);
+	void shrink(void);
+
+	static SharedLink create(std::string name = std::string(), MailBoxOptions options = MailBoxOptions());
 private:
-	Link(std::string name = std::string());
-	SharedQueue<Message> queue;
+	Link(std::string name, MailBoxOptions options);
+	MailBox<Message> queue;
 
-	void putMessage(MessageType type, Command command, RawData params, SharedSenderLink sender);
+	PostStatus putMessage(MessageType type, Command command, RawData params, SharedSenderLink sender, bool canBlock);
+	template<typename Iterator>
+	void putMessages(Iterator first, Iterator last, const SharedSenderLink &sender);
 };
 
 #endif
@@ -0,0 +1,63 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MAIL_BOX_OPTIONS_H__
+#define MAIL_BOX_OPTIONS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+enum class OverflowPolicy : uint32_t { BLOCK, FAIL, DROP_NEWEST, DROP_OLDEST, };
+
+/* DROPPED: the posted message with DROP_NEWEST, the oldest message of the mailbox with DROP_OLDEST. */
+enum class PostStatus : uint32_t { OK, FULL, DROPPED, };
+
+class MailBoxFull : public std::runtime_error {
+public:
+	MailBoxFull() : std::runtime_error("mailbox is full.") { }
+	~MailBoxFull() = default;
+};
+
+struct MailBoxOptions {
+	static const size_t UNBOUNDED = 0;
+
+	size_t capacity;
+	OverflowPolicy overflowPolicy;
+	/* maximum number of messages the consumer drains from the queue at once. */
+	size_t batchSize;
+	/* number of busy polls before an empty mailbox yields and then parks its consumer (0: park at once). */
+	size_t spinBudget;
+	explicit MailBoxOptions(size_t capacity = UNBOUNDED, OverflowPolicy overflowPolicy = OverflowPolicy::BLOCK,
+							size_t batchSize = 1, size_t spinBudget = 0) :
+									capacity(capacity), overflowPolicy(overflowPolicy),
+									batchSize((0 == batchSize) ? 1 : batchSize), spinBudget(spinBudget) { }
+};
+
+#endif
@@ -0,0 +1,266 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef PAYLOAD_SERIALIZER_H__
+#define PAYLOAD_SERIALIZER_H__
+
+#include <actor/rawData.h>
+
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+#include <cstddef>
+#include <type_traits>
+
+/*
+ * Compact binary encoding of the payloads. Fixed-width integers, enums and floats are big endian,
+ * like RawData(uint32_t). Strings, byte spans and sequences start with their size as a varint.
+ * Varints are only used for the fields wrapped by varint(): 7 bits per byte, zigzag for the
+ * signed integers.
+ *
+ * A struct lists its fields with PAYLOAD_FIELDS(a, b, c): encodePayload() and decodePayload()
+ * then handle it, and the structs and sequences it contains, without virtual call. encodePayload()
+ * computes the size of the message first and allocates its buffer once.
+ */
+#define PAYLOAD_FIELDS(...) \
+	template<typename Archive> void payloadFields(Archive &archive) { archive(__VA_ARGS__); } \
+	template<typename Archive> void payloadFields(Archive &archive) const { archive(__VA_ARGS__); }
+
+template<typename T>
+struct VarintField {
+	T &value;
+};
+
+template<typename T>
+VarintField<T> varint(T &value) {
+	static_assert(std::is_integral<typename std::remove_const<T>::type>::value, "only integers are varints.");
+	return VarintField<T> { value };
+}
+
+/* written like a RawData: read back as a RawData. */
+struct ByteSpan {
+	const void *data;
+	size_t size;
+};
+
+class PayloadSizer;
+class PayloadReader;
+
+template<typename T, typename = void>
+struct HasPayloadFields : std::false_type { };
+
+template<typename T>
+struct HasPayloadFields<T, decltype(std::declval<const T &>().payloadFields(std::declval<PayloadSizer &>()))> :
+																								std::true_type { };
+
+/* the encoding rules, shared by the sizing pass and the writer: Sink provides put(bytes, size). */
+template<typename Sink>
+class BasicPayloadWriter {
+public:
+	template<typename... T>
+	void operator()(const T &...values) {
+		const int unused[] = { 0, (write(values), 0)... };
+		(void) unused;
+	}
+
+	void write(bool value) { writeFixed(static_cast<uint8_t>(value)); }
+	template<typename T>
+	typename std::enable_if<std::is_integral<T>::value>::type write(T value) {
+		using Unsigned = typename std::make_unsigned<T>::type;
+		writeFixed(static_cast<Unsigned>(value));
+	}
+	template<typename T>
+	typename std::enable_if<std::is_enum<T>::value>::type write(T value) {
+		write(static_cast<typename std::underlying_type<T>::type>(value));
+	}
+	void write(float value) { writeFixed(bitsOf<uint32_t>(value)); }
+	void write(double value) { writeFixed(bitsOf<uint64_t>(value)); }
+	template<typename T>
+	void write(VarintField<T> field) { writeVarint(zigzag(field.value)); }
+
+	void write(const std::string &value) { write(ByteSpan { value.data(), value.size() }); }
+	void write(const RawData &value) { write(ByteSpan { value.data(), value.size() }); }
+	void write(const std::vector<uint8_t> &value) { write(ByteSpan { value.data(), value.size() }); }
+	void write(ByteSpan span) {
+		writeVarint(span.size);
+		sink().put(static_cast<const uint8_t *>(span.data), span.size);
+	}
+	template<typename T>
+	void write(const std::vector<T> &values) {
+		writeVarint(values.size());
+		for (const auto &v : values)
+			write(v);
+	}
+	template<typename T>
+	typename std::enable_if<HasPayloadFields<T>::value>::type write(const T &value) { value.payloadFields(*this); }
+
+	void writeVarint(uint64_t value) {
+		uint8_t bytes[10];
+		size_t size = 0;
+		for (; value >= 0x80; value >>= 7)
+			bytes[size++] = static_cast<uint8_t>(value | 0x80);
+		bytes[size++] = static_cast<uint8_t>(value);
+		sink().put(bytes, size);
+	}
+protected:
+	BasicPayloadWriter() = default;
+private:
+	Sink &sink(void) { return static_cast<Sink &>(*this); }
+
+	template<typename Unsigned>
+	void writeFixed(Unsigned value) {
+		uint8_t bytes[sizeof(Unsigned)];
+		for (size_t i = sizeof(Unsigned); i > 0; i--, value >>= 8)
+			bytes[i - 1] = static_cast<uint8_t>(value);
+		sink().put(bytes, sizeof(bytes));
+	}
+	template<typename Bits, typename Float>
+	static Bits bitsOf(Float value) {
+		static_assert(sizeof(Bits) == sizeof(Float), "unexpected size of floating point number.");
+		Bits bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		return bits;
+	}
+	template<typename T>
+	static uint64_t zigzag(T value) {
+		const auto v = static_cast<int64_t>(value);
+		return std::is_signed<T>::value ? (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63) :
+											static_cast<uint64_t>(value);
+	}
+};
+
+class PayloadSizer : public BasicPayloadWriter<PayloadSizer> {
+public:
+	PayloadSizer() : size(0) { }
+	void put(const uint8_t *, size_t n) { size += n; }
+	size_t getSize(void) const { return size; }
+private:
+	size_t size;
+};
+
+/* appends to data: reserve its capacity first (see encodePayload()). */
+class PayloadWriter : public BasicPayloadWriter<PayloadWriter> {
+public:
+	explicit PayloadWriter(RawData &data) : data(data) { }
+	void put(const uint8_t *bytes, size_t n) { data.append(bytes, n); }
+private:
+	RawData &data;
+};
+
+/* throws std::runtime_error when the payload is shorter than its fields. */
+class PayloadReader {
+public:
+	explicit PayloadReader(const RawData &data) : data(data), offset(0) { }
+
+	template<typename... T>
+	void operator()(T &&...values) {
+		const int unused[] = { 0, (read(values), 0)... };
+		(void) unused;
+	}
+
+	void read(bool &value) { value = 0 != readFixed<uint8_t>(); }
+	template<typename T>
+	typename std::enable_if<std::is_integral<T>::value>::type read(T &value) {
+		value = static_cast<T>(readFixed<typename std::make_unsigned<T>::type>());
+	}
+	template<typename T>
+	typename std::enable_if<std::is_enum<T>::value>::type read(T &value) {
+		typename std::underlying_type<T>::type v;
+		read(v);
+		value = static_cast<T>(v);
+	}
+	void read(float &value) { fromBits(readFixed<uint32_t>(), value); }
+	void read(double &value) { fromBits(readFixed<uint64_t>(), value); }
+	template<typename T>
+	void read(VarintField<T> field) {
+		const auto v = readVarint();
+		field.value = static_cast<T>(std::is_signed<T>::value ? (v >> 1) ^ (~(v & 1) + 1) : v);
+	}
+
+	void read(std::string &value);
+	void read(RawData &value);
+	void read(std::vector<uint8_t> &value);
+	template<typename T>
+	void read(std::vector<T> &values) {
+		const auto size = readVarint();
+		values.clear();
+		values.reserve(std::min<uint64_t>(size, remaining()));
+		for (uint64_t i = 0; i < size; i++) {
+			values.emplace_back();
+			read(values.back());
+		}
+	}
+	template<typename T>
+	typename std::enable_if<HasPayloadFields<T>::value>::type read(T &value) { value.payloadFields(*this); }
+
+	uint64_t readVarint(void);
+	size_t remaining(void) const { return data.size() - offset; }
+private:
+	const RawData &data;
+	size_t offset;
+
+	/* the next n bytes of the payload. */
+	const uint8_t *take(size_t n);
+	template<typename Unsigned>
+	Unsigned readFixed(void) {
+		const auto bytes = take(sizeof(Unsigned));
+		Unsigned value = 0;
+		for (size_t i = 0; i < sizeof(Unsigned); i++)
+			value = static_cast<Unsigned>(value << 8) | bytes[i];
+		return value;
+	}
+	template<typename Bits, typename Float>
+	static void fromBits(Bits bits, Float &value) {
+		static_assert(sizeof(Bits) == sizeof(Float), "unexpected size of floating point number.");
+		std::memcpy(&value, &bits, sizeof(value));
+	}
+};
+
+template<typename T>
+RawData encodePayload(const T &value) {
+	PayloadSizer sizer;
+	sizer.write(value);
+	RawData data;
+	data.reserve(sizer.getSize());
+	PayloadWriter writer(data);
+	writer.write(value);
+	return data;
+}
+
+template<typename T>
+T decodePayload(const RawData &data) {
+	T value;
+	PayloadReader reader(data);
+	reader.read(value);
+	return value;
+}
+
+#endif
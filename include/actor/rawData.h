@@ -34,23 +34,162 @@
 
 #include <vector>
 #include <string>
+#include <memory>
+#include <initializer_list>
+#include <type_traits>
 #include <cstddef>
+#include <algorithm>
+#include <iterator>
 
+class TypedObject;
 
-class RawData : public std::vector<uint8_t> {
+/*
+ * Bytes of a message. Payloads of up to INLINE_CAPACITY bytes are stored in the object itself and
+ * never allocate. Copies of a larger payload share one immutable buffer: posting, forwarding or
+ * storing it never copies the bytes. A shared buffer is only copied when one of its owners modifies
+ * it (copy on write): read a received payload through a const reference.
+ * A payload can also carry an object instead of bytes (see typedPayload.h): it is only serialized
+ * when it leaves the process.
+ */
+class RawData {
 public:
-	using v = std::vector<uint8_t>;
-	using v::v;
+	static const size_t INLINE_CAPACITY = 32;
+
+	using value_type = uint8_t;
+	using size_type = size_t;
+	using difference_type = std::ptrdiff_t;
+	using reference = uint8_t &;
+	using const_reference = const uint8_t &;
+	using pointer = uint8_t *;
+	using const_pointer = const uint8_t *;
+	using iterator = uint8_t *;
+	using const_iterator = const uint8_t *;
 
 	RawData();
-	/* add a constructor and move constructor for a vector */
 	RawData(uint32_t value);
-	RawData(void *buffer, size_t size);
+	explicit RawData(size_t size, uint8_t value = 0);
+	RawData(const void *buffer, size_t size);
 	RawData(const std::string &s);
+	RawData(std::initializer_list<uint8_t> bytes);
+	/* takes the bytes over without copying them. */
+	explicit RawData(std::vector<uint8_t> &&bytes);
+	/* a payload without bytes carrying the object. */
+	explicit RawData(std::shared_ptr<const TypedObject> object);
+	template<typename ForwardIterator,
+				typename = typename std::enable_if<!std::is_integral<ForwardIterator>::value>::type>
+	RawData(ForwardIterator first, ForwardIterator last) : RawData() { append(first, last); }
 	~RawData();
 
+	RawData(const RawData &d) = default;
+	RawData(RawData &&d) noexcept = default;
+	RawData &operator=(const RawData &d) = default;
+	RawData &operator=(RawData &&d) noexcept = default;
+
+	size_t size(void) const { return (nullptr == bytes) ? length : bytes->size(); }
+	bool empty(void) const { return 0 == size(); }
+	/*
+	 * INLINE_CAPACITY while the bytes are inline, else the capacity of the buffer. A shared buffer is
+	 * copied at the first write: its capacity is not available to this payload before. Unlike
+	 * std::vector, clear() releases the buffer.
+	 */
+	size_t capacity(void) const { return (nullptr == bytes) ? INLINE_CAPACITY : bytes->capacity(); }
+
+	const uint8_t *data(void) const { return (nullptr == bytes) ? inlineBytes : bytes->data(); }
+	/*
+	 * the non-const accessors (data(), operator[], at(), front(), back(), begin() and end()) give write
+	 * access: they copy a shared buffer first, even when the caller only reads. Read through a const
+	 * reference to keep sharing it.
+	 */
+	uint8_t *data(void) { return (nullptr == bytes) ? inlineBytes : own().data(); }
+	const uint8_t &operator[](size_t i) const { return data()[i]; }
+	uint8_t &operator[](size_t i) { return data()[i]; }
+	const uint8_t &at(size_t i) const;
+	uint8_t &at(size_t i);
+
+	const uint8_t &front(void) const { return (*this)[0]; }
+	uint8_t &front(void) { return (*this)[0]; }
+	const uint8_t &back(void) const { return (*this)[size() - 1]; }
+	uint8_t &back(void) { return (*this)[size() - 1]; }
+
+	const_iterator begin(void) const { return data(); }
+	const_iterator end(void) const { return data() + size(); }
+	const_iterator cbegin(void) const { return begin(); }
+	const_iterator cend(void) const { return end(); }
+	iterator begin(void) { return data(); }
+	iterator end(void) { return data() + size(); }
+
+	void push_back(uint8_t byte);
+	void pop_back(void) { resize(size() - 1); }
+	template<typename ForwardIterator>
+	void append(ForwardIterator first, ForwardIterator last) {
+		const auto offset = size();
+		resize(offset + std::distance(first, last));
+		std::copy(first, last, data() + offset);
+	}
+	void append(const void *buffer, size_t size);
+	/* the range must not be part of this payload. */
+	template<typename ForwardIterator,
+				typename = typename std::enable_if<!std::is_integral<ForwardIterator>::value>::type>
+	iterator insert(const_iterator position, ForwardIterator first, ForwardIterator last) {
+		const auto room = open(position - cbegin(), std::distance(first, last));
+		std::copy(first, last, room);
+		return room;
+	}
+	iterator insert(const_iterator position, size_t count, uint8_t value);
+	iterator insert(const_iterator position, uint8_t value) { return insert(position, 1, value); }
+	iterator insert(const_iterator position, std::initializer_list<uint8_t> bytes) {
+		return insert(position, bytes.begin(), bytes.end());
+	}
+	iterator erase(const_iterator first, const_iterator last);
+	iterator erase(const_iterator position) { return erase(position, position + 1); }
+	template<typename ForwardIterator,
+				typename = typename std::enable_if<!std::is_integral<ForwardIterator>::value>::type>
+	void assign(ForwardIterator first, ForwardIterator last) { clear(); append(first, last); }
+	void assign(size_t count, uint8_t value) { clear(); resize(count, value); }
+	void assign(std::initializer_list<uint8_t> bytes) { assign(bytes.begin(), bytes.end()); }
+	void resize(size_t size, uint8_t value = 0);
+	void reserve(size_t capacity);
+	/* a shared buffer is kept as it is: the other owners still use it. */
+	void shrink_to_fit(void);
+	void clear(void) { bytes.reset(); length = 0; object.reset(); }
+	void swap(RawData &d) noexcept { std::swap(*this, d); }
+	size_t max_size(void) const { return std::vector<uint8_t>().max_size(); }
+
+	/* true when both payloads use the same buffer: inline payloads are never shared. */
+	bool shares(const RawData &d) const { return nullptr != bytes && bytes == d.bytes; }
+
+	bool operator==(const RawData &d) const;
+	bool operator!=(const RawData &d) const { return !(*this == d); }
+	/* the bytes are compared as std::vector<uint8_t> does: the objects are not. */
+	bool operator<(const RawData &d) const { return std::lexicographical_compare(begin(), end(), d.begin(), d.end()); }
+	bool operator>(const RawData &d) const { return d < *this; }
+	bool operator<=(const RawData &d) const { return !(d < *this); }
+	bool operator>=(const RawData &d) const { return !(*this < d); }
+
+	/* a copy of the bytes, for the code written for std::vector<uint8_t>. */
+	operator std::vector<uint8_t>() const { return std::vector<uint8_t>(begin(), end()); }
+
+	/* null when the payload only has bytes. */
+	const TypedObject *getObject(void) const { return object.get(); }
+	/* the bytes to send to another process: the object is encoded when the payload carries one. */
+	RawData serialized(void) const;
+
 	std::string toString() const;
 	uint32_t toInt() const;
+private:
+	/* null while the payload is inline. */
+	std::shared_ptr<std::vector<uint8_t>> bytes;
+	/* size of an inline payload. */
+	size_t length;
+	uint8_t inlineBytes[INLINE_CAPACITY];
+	std::shared_ptr<const TypedObject> object;
+
+	/* the buffer of this payload only, copied first when it is shared. */
+	std::vector<uint8_t> &own(void);
+	/* moves an inline payload to a buffer of the given capacity. */
+	void spill(size_t capacity);
+	/* makes room for count bytes at offset: returns the start of that room. */
+	iterator open(size_t offset, size_t count);
 };
 
 #endif
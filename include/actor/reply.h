@@ -0,0 +1,70 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef REPLY_H__
+#define REPLY_H__
+
+#include <actor/rawData.h>
+
+#include <chrono>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+
+class ReplyTimeout : public std::runtime_error {
+public:
+	ReplyTimeout() : std::runtime_error("no reply before the timeout.") { }
+	~ReplyTimeout() = default;
+};
+
+class ReplySlot;
+
+/* answer to an ask(): the first message the receiver posts to the sender of the command. */
+class Reply {
+public:
+	Reply(std::shared_ptr<ReplySlot> slot, unsigned int timeout_in_ms);
+	~Reply();
+
+	/* waits until the reply arrived or the timeout given to ask() expired. */
+	bool wait(void) const;
+	bool isReady(void) const;
+	/* both wait and throw ReplyTimeout when no reply arrived in time. */
+	Command getCommand(void) const;
+	RawData get(void) const;
+	/*
+	 * calls callback once, when the reply arrives or when the timeout expires, from the replying
+	 * thread or the timer thread. To be called at most once per ask.
+	 */
+	void then(std::function<void(void)> callback) const;
+private:
+	std::shared_ptr<ReplySlot> slot;
+	const std::chrono::steady_clock::time_point deadline;
+};
+
+#endif
@@ -0,0 +1,90 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef ROUTER_H__
+#define ROUTER_H__
+
+#include <actor/actor.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum class RoutingPolicy {
+	/* each routee in turn. */
+	ROUND_ROBIN,
+	/* the routee with the fewest messages waiting in its mailbox. */
+	LEAST_QUEUE_DEPTH,
+	/* messages with the same key always reach the same routee. */
+	CONSISTENT_HASH,
+};
+
+using RoutingKey = std::function<std::string(Command command, const RawData &params)>;
+
+/*
+ * routes on the whole payload. A payload carrying an object routes on its encoding: the objects
+ * without PayloadCodec need a RoutingKey of their own.
+ */
+extern const RoutingKey PAYLOAD_ROUTING_KEY;
+
+/*
+ * Sends each message to one of nbRoutees identical actors. The link of a router routes the messages
+ * as well, so a router registered in an ActorRegistry balances the messages of remote clients.
+ */
+class Router : public SharableSenderApi {
+public:
+	Router(std::string name, size_t nbRoutees, CommandExecutorFactory factory,
+			RoutingPolicy policy = RoutingPolicy::ROUND_ROBIN, ActorOptions options = ActorOptions(),
+			RoutingKey key = PAYLOAD_ROUTING_KEY);
+	~Router();
+
+	Router(const Router &r) = delete;
+	Router &operator=(const Router &r) = delete;
+
+	void post(Command command, SharedSenderLink sender = SharedSenderLink()) const;
+	void post(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink()) const;
+	Reply ask(Command command, unsigned int timeout_in_ms) const;
+	Reply ask(Command command, const RawData &params, unsigned int timeout_in_ms) const;
+
+	const std::string &getName(void) const;
+	SharedSenderLink getActorLinkRef() const override;
+
+	size_t getNbRoutees(void) const;
+	Actor &getRoutee(size_t index) const;
+
+private:
+	class RouterLink;
+
+	const std::vector<std::unique_ptr<Actor>> routees;
+	const std::shared_ptr<RouterLink> link;
+};
+
+#endif
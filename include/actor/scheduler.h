@@ -0,0 +1,83 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SCHEDULER_H__
+#define SCHEDULER_H__
+
+#include <actor/placement.h>
+
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+class Scheduler;
+using SharedScheduler = std::shared_ptr<Scheduler>;
+
+struct SchedulingStatistics {
+	/* number of times actors were run by a worker. */
+	uint64_t nbTurns;
+	/* number of turns ended because the actor used its message budget while messages were waiting. */
+	uint64_t nbBudgetExhausted;
+	SchedulingStatistics(uint64_t nbTurns = 0, uint64_t nbBudgetExhausted = 0) :
+												nbTurns(nbTurns), nbBudgetExhausted(nbBudgetExhausted) { }
+};
+
+/*
+ * Fixed pool of worker threads shared by actors: an actor using a scheduler owns no thread and
+ * only runs on a worker while its mailbox holds messages. After processing its message budget,
+ * an actor goes behind the other runnable actors.
+ */
+class Scheduler {
+public:
+	static const unsigned int HARDWARE_CONCURRENCY = 0;
+	static const size_t DEFAULT_MESSAGE_BUDGET = 64;
+
+	/* with CPUs given, each worker is pinned to one of them in turn. */
+	explicit Scheduler(unsigned int nbWorkers = HARDWARE_CONCURRENCY, CpuSet cpus = CpuSet(),
+						size_t messageBudget = DEFAULT_MESSAGE_BUDGET);
+	~Scheduler();
+
+	Scheduler(const Scheduler &s) = delete;
+	Scheduler &operator=(const Scheduler &s) = delete;
+
+	unsigned int getNbWorkers(void) const;
+	Placement getPlacement(void) const;
+	size_t getMessageBudget(void) const;
+	SchedulingStatistics getStatistics(void) const;
+
+	static SharedScheduler create(unsigned int nbWorkers = HARDWARE_CONCURRENCY, CpuSet cpus = CpuSet(),
+									size_t messageBudget = DEFAULT_MESSAGE_BUDGET);
+private:
+	friend class PooledExecutor;
+	class SchedulerImpl;
+
+	SchedulerImpl *pImpl;
+};
+
+#endif
@@ -31,11 +31,26 @@
 #define LINK_API_H__
 
 #include <actor/rawData.h>
+#include <actor/mailBoxOptions.h>
+#include <actor/typedPayload.h>
+#include <actor/reply.h>
 
 #include <memory>
+#include <utility>
+#include <type_traits>
 
 class SenderApi;
 using SharedSenderLink = std::shared_ptr<SenderApi>;
+using PostedCommand = std::pair<Command, RawData>;
+
+/*
+ * the arguments converted to RawData or to a sender keep their meaning: the others are posted as objects.
+ * Pointers and arrays, string literals included, are not posted as objects: posting one does not compile.
+ */
+template<typename T>
+using EnableIfTypedObject = typename std::enable_if<!std::is_convertible<T, RawData>::value &&
+													!std::is_convertible<T, SharedSenderLink>::value &&
+													!std::is_pointer<typename std::decay<T>::type>::value>::type;
 
 class SharableSenderApi {
 public:
@@ -49,6 +64,23 @@ class SenderApi {
 public:
 	virtual void post(Command command, SharedSenderLink sender = SharedSenderLink()) = 0;
 	virtual void post(Command command, const RawData &data, SharedSenderLink sender = SharedSenderLink()) = 0;
+	/* for the receivers that can keep the payload: the others get it as a const reference. */
+	virtual void post(Command command, RawData &&data, SharedSenderLink sender = SharedSenderLink());
+	/*
+	 * FULL when the mailbox of the receiver has no room. The default calls post() and may block: a
+	 * receiver that queues in a bounded mailbox, or forwards to one, must override it.
+	 */
+	virtual PostStatus tryPost(Command command, const RawData &data, SharedSenderLink sender = SharedSenderLink());
+	/* posts a command whose answer must reach replyTo, even when the receiver is remote. */
+	virtual void request(Command command, const RawData &data, SharedSenderLink replyTo);
+	/* the object is moved to the receiver: it is only serialized when the receiver is remote. */
+	template<typename T, typename = EnableIfTypedObject<T>>
+	void post(Command command, T &&object, SharedSenderLink sender = SharedSenderLink()) {
+		post(command, typedPayload(std::forward<T>(object)), std::move(sender));
+	}
+
+	Reply ask(Command command, unsigned int timeout_in_ms);
+	Reply ask(Command command, const RawData &data, unsigned int timeout_in_ms);
 
 	const std::string &getName(void) const;
 	bool hasName(const std::string &n) const;
@@ -0,0 +1,117 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef TYPED_PAYLOAD_H__
+#define TYPED_PAYLOAD_H__
+
+#include <actor/rawData.h>
+#include <actor/payloadSerializer.h>
+
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Serialization of the objects sent to other processes: specialize it with
+ *	static RawData encode(const T &value);
+ *	static T decode(const RawData &data);
+ * The structs listing their fields with PAYLOAD_FIELDS() have one. Objects of the types without
+ * codec can only be posted to the actors of this process.
+ */
+template<typename T, typename = void>
+struct PayloadCodec { };
+
+template<typename T>
+struct PayloadCodec<T, typename std::enable_if<HasPayloadFields<T>::value>::type> {
+	static RawData encode(const T &value) { return encodePayload(value); }
+	static T decode(const RawData &data) { return decodePayload<T>(data); }
+};
+
+template<>
+struct PayloadCodec<uint32_t> {
+	static RawData encode(uint32_t value) { return RawData(value); }
+	static uint32_t decode(const RawData &data) { return data.toInt(); }
+};
+
+template<>
+struct PayloadCodec<std::string> {
+	static RawData encode(const std::string &value) { return RawData(value); }
+	static std::string decode(const RawData &data) { return data.toString(); }
+};
+
+template<typename T, typename = void>
+struct HasPayloadCodec : std::false_type { };
+
+template<typename T>
+struct HasPayloadCodec<T, decltype(void(PayloadCodec<T>::encode(std::declval<const T &>())))> : std::true_type { };
+
+class TypedObject {
+public:
+	virtual ~TypedObject() = default;
+	virtual RawData encode(void) const = 0;
+protected:
+	TypedObject() = default;
+};
+
+[[noreturn]] void throwNoPayloadCodec(void);
+
+template<typename T>
+class TypedValue : public TypedObject {
+public:
+	explicit TypedValue(T value) : value(std::move(value)) { }
+
+	RawData encode(void) const override { return encodeValue(value, HasPayloadCodec<T>()); }
+	/* for the payloads received from other processes. */
+	static T decode(const RawData &data) { return decodeValue(data, HasPayloadCodec<T>()); }
+
+	const T value;
+private:
+	static RawData encodeValue(const T &value, std::true_type) { return PayloadCodec<T>::encode(value); }
+	static RawData encodeValue(const T &, std::false_type) { throwNoPayloadCodec(); }
+	static T decodeValue(const RawData &data, std::true_type) { return PayloadCodec<T>::decode(data); }
+	static T decodeValue(const RawData &, std::false_type) { throwNoPayloadCodec(); }
+};
+
+/* the object is moved into the payload: copies of the payload share it. */
+template<typename T>
+RawData typedPayload(T &&object) {
+	using Value = typename std::decay<T>::type;
+	return RawData(std::make_shared<const TypedValue<Value>>(std::forward<T>(object)));
+}
+
+/* null when the payload does not carry an object of type T. */
+template<typename T>
+const T *payloadObject(const RawData &data) {
+	const auto typed = dynamic_cast<const TypedValue<T> *>(data.getObject());
+	return (nullptr == typed) ? nullptr : &typed->value;
+}
+
+#endif
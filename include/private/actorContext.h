@@ -45,10 +45,14 @@ public:
 	void restartActors() const override;
 	void stopActors() const override;
 	State &getState() override;
+	std::function<void(void)> continuation(ContinuationTask task) const override;
+	void watch(int fd, uint32_t events, Command command) const override;
+	void unwatch(int fd) const override;
 
 	Supervisor &getSupervisor();
 	const Supervisor &getConstSupervisor() const;
 private:
+	const SharedLink self;
 	std::unique_ptr<State> state;
 	Supervisor supervisor;
 };
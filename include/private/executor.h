@@ -31,31 +31,70 @@
 #define EXECUTOR_H__
 
 #include <actor/link.h>
+#include <private/executorApi.h>
 
 #include <functional>
 #include <thread>
+#include <mutex>
+#include <condition_variable>
 
 using ExecutorBody = std::function<StatusCode(MessageType, Command, const RawData &data, const SharedSenderLink &sender)>;
 using ExecutorHook = std::function<void(void)>;
 using ExecutorAtStart = std::function<StatusCode(void)>;
 
-class Executor {
+/* an executor without message for idleTimeout ms ends its thread, the next message starts another one. */
+struct Hibernation {
+	/* in ms, 0: the executor keeps its thread. */
+	unsigned int idleTimeout;
+	ExecutorHook atHibernate;
+	ExecutorHook atWake;
+	Hibernation(unsigned int idleTimeout = 0, ExecutorHook atHibernate = [](void) { },
+				ExecutorHook atWake = [](void) { }) :
+							idleTimeout(idleTimeout), atHibernate(atHibernate), atWake(atWake) { }
+};
+
+class Executor : public ExecutorApi {
 public:
 	Executor(ExecutorBody body, Link &queue, ExecutorAtStart atStart = [](void) { return StatusCode::OK; },
-													ExecutorHook atStop = [](void) { });
+				ExecutorHook atStop = [](void) { }, CpuSet cpus = CpuSet(), Hibernation hibernation = Hibernation());
 	~Executor();
 
+	Placement getPlacement(void) override;
+	/* a thread-per-actor executor is never scheduled. */
+	SchedulingStatistics getStatistics(void) const override { return SchedulingStatistics(); }
+	bool waitTerminated(std::chrono::steady_clock::time_point deadline) override;
+
 	Executor() = delete;
 	Executor(const Executor &a) = delete;
 	Executor &operator=(const Executor &a) = delete;
 	Executor(Executor &&a) = delete;
 	Executor &operator=(Executor &&a) = delete;
 private:
+	const ExecutorBody body;
 	Link &messageQueue;
+	const ExecutorHook atStop;
+	const CpuSet cpus;
+	const Hibernation hibernation;
+	std::mutex mutex;
+	std::condition_variable wakeUpCondition;
+	std::condition_variable terminatedCondition;
+	std::condition_variable resumedCondition;
+	bool woken;
+	bool hibernated;
+	/* woken up from hibernation, the new thread is not started yet. */
+	bool resuming;
+	bool terminated;
+	Placement placement;
 	std::thread thread;
 
-	void run(ExecutorBody body, ExecutorAtStart atStart, ExecutorHook atStop) const;
-	void executeBody(ExecutorBody body) const;
+	void run(ExecutorAtStart atStart);
+	void resume(void);
+	void runBody(void);
+	void terminate(void);
+	bool executeBody(void);
+	bool waitMessage(void);
+	void wakeUp(void);
+	void respawn(void);
 };
 
 
@@ -0,0 +1,303 @@
+/* Copyright 2016 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MAIL_BOX_H__
+#define MAIL_BOX_H__
+
+#include <actor/mailBoxOptions.h>
+#include <private/mpscQueue.h>
+#include <private/cpuRelax.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <chrono>
+#include <vector>
+#include <algorithm>
+#include <thread>
+
+/*
+ * Mailbox with lock-free posting. The mutex and the condition variables are only used
+ * to park the consumer when the queue is empty or producers blocked on a full bounded
+ * mailbox: nobody touches them as long as nobody has to wait.
+ * Control messages use their own unbounded lane so that they never wait behind the
+ * regular backlog. The internal messages forced in the regular lane count in its size
+ * but DROP_OLDEST never evicts them: evictable tells them apart.
+ */
+template<typename T>
+class MailBox {
+public:
+	using Batch = typename MpscQueue<T>::Chain;
+
+	MailBox(MailBoxOptions options = MailBoxOptions(), std::function<T(void)> invalidValue = [](){ return T(); },
+			std::function<bool(const T &)> evictable = [](const T &) { return true; }) :
+					options(options), invalidValue(invalidValue), evictable(evictable), nbMessages(0), nbToDrop(0),
+					sleeping(false), nbBlockedProducers(0), nextInBatch(0) { }
+	~MailBox() = default;
+
+	MailBox(const MailBox &m) = delete;
+	MailBox &operator=(const MailBox &m) = delete;
+
+	PostStatus post(T &&v) { return post(std::forward<T>(v), 1, true); }
+
+	PostStatus tryPost(T &&v) { return post(std::forward<T>(v), 1, false); }
+
+	/* the whole batch is accepted or rejected at once and is received contiguously. */
+	PostStatus post(Batch &&batch) { return post(std::move(batch), batch.size(), true); }
+
+	PostStatus tryPost(Batch &&batch) { return post(std::move(batch), batch.size(), false); }
+
+	/* used for internal messages that must never be lost nor wait for room: they must not be evictable. */
+	void forcePost(T &&v) {
+		nbMessages++;
+		push(q, std::forward<T>(v));
+	}
+
+	/* control lane: delivered before any message waiting in the regular lane. */
+	void postUrgent(T &&v) { push(urgent, std::forward<T>(v)); }
+
+	T get(void) {
+		return get([this](std::unique_lock<std::mutex> &l) {
+			condition.wait(l, [this]() { return !isEmpty(); });
+			return true;
+		});
+	}
+
+	T get(unsigned int timeout_in_ms) {
+		std::chrono::milliseconds timeout(timeout_in_ms);
+		return get([this, &timeout](std::unique_lock<std::mutex> &l) {
+			return condition.wait_for(l, timeout, [this]() { return !isEmpty(); });
+		});
+	}
+
+	/* replaces the condition variable for a consumer that is scheduled instead of blocked in get(). */
+	void setWakeUp(std::function<void(void)> wakeUp) { this->wakeUp = std::move(wakeUp); }
+
+	/* consumer side: true when get() returns without waiting. */
+	bool hasMessage(void) const { return batch.size() != nextInBatch || !isEmpty(); }
+
+	/*
+	 * consumer side, for a consumer that does not wait in get(): returns false when a message arrived in
+	 * the meantime and must still be processed. Otherwise the next post calls the wake up function once.
+	 */
+	bool trySleep(void) {
+		sleeping = true;
+		return !hasMessage() || !sleeping.exchange(false);
+	}
+
+	/* consumer side: frees the batch once it is consumed, the next get() allocates it again. */
+	void shrink(void) {
+		if (batch.size() != nextInBatch)
+			return ;
+		std::vector<T>().swap(batch);
+		nextInBatch = 0;
+	}
+
+	/* messages already drained by the consumer are not counted. */
+	size_t size(void) const { return nbMessages; }
+private:
+	using WaitMessage = std::function<bool(std::unique_lock<std::mutex> &)>;
+
+	template<typename V>
+	PostStatus post(V &&v, size_t nbMessagesPosted, bool canBlock) {
+		if (0 == nbMessagesPosted)
+			return PostStatus::OK;
+		const auto status = admit(nbMessagesPosted, canBlock);
+		if (isAdmitted(status))
+			push(q, std::forward<V>(v));
+		return status;
+	}
+
+	/* DROP_OLDEST admits the message and reports DROPPED for the message it evicts. */
+	bool isAdmitted(PostStatus status) const {
+		return PostStatus::OK == status ||
+				(PostStatus::DROPPED == status && OverflowPolicy::DROP_OLDEST == options.overflowPolicy);
+	}
+
+	PostStatus admit(size_t n, bool canBlock) {
+		if (reserve(n))
+			return PostStatus::OK;
+		switch (options.overflowPolicy) {
+			case OverflowPolicy::BLOCK:
+				if (!canBlock || n > options.capacity)
+					return PostStatus::FULL;
+				waitRoom(n);
+				return PostStatus::OK;
+			case OverflowPolicy::FAIL:
+				return PostStatus::FULL;
+			case OverflowPolicy::DROP_NEWEST:
+				return PostStatus::DROPPED;
+			case OverflowPolicy::DROP_OLDEST:
+				return overwriteOldest(n) ? PostStatus::DROPPED : PostStatus::OK;
+		}
+		return PostStatus::FULL;
+	}
+
+	bool reserve(size_t n) {
+		if (MailBoxOptions::UNBOUNDED == options.capacity)
+			return (nbMessages += n, true);
+		auto current = nbMessages.load();
+		while (current + n <= options.capacity) {
+			if (nbMessages.compare_exchange_weak(current, current + n))
+				return true;
+		}
+		return false;
+	}
+
+	/* false when the consumer made room in the meantime. */
+	bool overwriteOldest(size_t n) {
+		const auto previous = nbMessages.fetch_add(n);
+		if (previous + n <= options.capacity)
+			return false;
+		nbToDrop += std::min(n, previous + n - options.capacity);
+		return true;
+	}
+
+	void waitRoom(size_t n) {
+		std::unique_lock<std::mutex> l(mutexRoom);
+
+		nbBlockedProducers++;
+		room.wait(l, [this, n]() { return reserve(n); });
+		nbBlockedProducers--;
+	}
+
+	template<typename V>
+	void push(MpscQueue<T> &lane, V &&v) {
+		lane.push(std::forward<V>(v));
+		if (!sleeping)
+			return ;
+		if (wakeUp) {
+			if (sleeping.exchange(false))
+				wakeUp();
+			return ;
+		}
+		std::unique_lock<std::mutex> l(mutexQueue);
+		condition.notify_one();
+	}
+
+	T get(WaitMessage &&waitMessage) {
+		while (batch.size() == nextInBatch && urgent.empty()) {
+			if (!fillBatch(waitMessage))
+				return invalidValue();
+		}
+		if (!urgent.empty())
+			return urgent.pop();
+		return std::move(batch[nextInBatch++]);
+	}
+
+	bool fillBatch(WaitMessage &waitMessage) {
+		/* allocated by the consumer thread to be local to the CPU that reads it. */
+		if (batch.capacity() < options.batchSize)
+			batch.reserve(options.batchSize);
+		batch.clear();
+		nextInBatch = 0;
+		if (isEmpty() && !spin() && !park(waitMessage))
+			return false;
+		dropOldest();
+		while (batch.size() < options.batchSize && !q.empty())
+			batch.push_back(q.pop());
+		release(batch.size());
+		return true;
+	}
+
+	bool isEmpty(void) const { return q.empty() && urgent.empty(); }
+
+	/*
+	 * adaptive wait: avoids the futex round trip when the answer comes back quickly.
+	 * Busy polling is pointless when the producer cannot run at the same time.
+	 */
+	bool spin(void) const {
+		static const size_t NB_YIELDS = 16;
+		static const bool canSpin = (1 < std::thread::hardware_concurrency());
+
+		if (0 == options.spinBudget)
+			return false;
+		for (size_t i = 0; canSpin && i < options.spinBudget; i++) {
+			if (!isEmpty())
+				return true;
+			cpuRelax();
+		}
+		for (size_t i = 0; i < NB_YIELDS; i++) {
+			if (!isEmpty())
+				return true;
+			std::this_thread::yield();
+		}
+		return !isEmpty();
+	}
+
+	bool park(WaitMessage &waitMessage) {
+		std::unique_lock<std::mutex> l(mutexQueue);
+
+		sleeping = true;
+		const auto available = waitMessage(l);
+		sleeping = false;
+		return available;
+	}
+
+	/* the internal messages met on the way are kept in the batch, in order. */
+	void dropOldest(void) {
+		while (0 < nbToDrop && !q.empty()) {
+			auto m = q.pop();
+			if (!evictable(m)) {
+				batch.push_back(std::move(m));
+				continue;
+			}
+			nbToDrop--;
+			release(1);
+		}
+	}
+
+	void release(size_t nbReleased) {
+		nbMessages -= nbReleased;
+		if (0 == nbBlockedProducers)
+			return ;
+		std::unique_lock<std::mutex> l(mutexRoom);
+		room.notify_all();
+	}
+
+	const MailBoxOptions options;
+	MpscQueue<T> q;
+	MpscQueue<T> urgent;
+	std::function<T(void)> invalidValue;
+	const std::function<bool(const T &)> evictable;
+	std::function<void(void)> wakeUp;
+	std::atomic<size_t> nbMessages;
+	std::atomic<size_t> nbToDrop;
+	std::atomic<bool> sleeping;
+	std::mutex mutexQueue;
+	std::condition_variable condition;
+	std::atomic<unsigned int> nbBlockedProducers;
+	std::mutex mutexRoom;
+	std::condition_variable room;
+	std::vector<T> batch;
+	size_t nextInBatch;
+};
+
+#endif
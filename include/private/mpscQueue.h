@@ -0,0 +1,144 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef MPSC_QUEUE_H__
+#define MPSC_QUEUE_H__
+
+#include <private/nodePool.h>
+
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Intrusive multi-producer / single-consumer FIFO (D. Vyukov's algorithm).
+ * push() never takes a lock: a producer swaps itself in as the new head and then links
+ * the previous head to its node. The consumer owns the tail and is the only one
+ * allowed to call empty() and pop().
+ */
+template<typename T>
+class MpscQueue {
+	struct Node {
+		std::atomic<Node *> next;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+		Node() : next(nullptr) { }
+		T &value() { return *reinterpret_cast<T *>(&storage); }
+
+		static void *operator new(size_t) { return NodePool<Node>::allocate(); }
+		static void operator delete(void *ptr) { NodePool<Node>::release(ptr); }
+	};
+public:
+	/* nodes linked by a single producer and published at once by push(Chain &&). */
+	class Chain {
+	public:
+		Chain() : first(nullptr), last(nullptr), length(0) { }
+		~Chain() {
+			while (nullptr != first) {
+				const auto node = first;
+				first = node->next.load(std::memory_order_relaxed);
+				node->value().~T();
+				delete node;
+			}
+		}
+		Chain(const Chain &c) = delete;
+		Chain &operator=(const Chain &c) = delete;
+		Chain(Chain &&c) : first(c.first), last(c.last), length(c.length) { c.reset(); }
+		Chain &operator=(Chain &&c) = delete;
+
+		void append(T &&v) {
+			const auto node = newNode(std::forward<T>(v));
+			if (nullptr == last)
+				first = node;
+			else
+				last->next.store(node, std::memory_order_relaxed);
+			last = node;
+			length++;
+		}
+		size_t size(void) const { return length; }
+	private:
+		friend class MpscQueue;
+		Node *first;
+		Node *last;
+		size_t length;
+
+		void reset(void) {
+			first = last = nullptr;
+			length = 0;
+		}
+	};
+
+	MpscQueue() : head(new Node()), tail(head.load()) { }
+	~MpscQueue() {
+		while (!empty())
+			pop();
+		delete tail;
+	}
+
+	MpscQueue(const MpscQueue &q) = delete;
+	MpscQueue &operator=(const MpscQueue &q) = delete;
+	MpscQueue(MpscQueue &&q) = delete;
+	MpscQueue &operator=(MpscQueue &&q) = delete;
+
+	void push(T &&v) {
+		const auto node = newNode(std::forward<T>(v));
+		head.exchange(node)->next.store(node);
+	}
+
+	void push(Chain &&chain) {
+		if (0 == chain.size())
+			return ;
+		head.exchange(chain.last)->next.store(chain.first);
+		chain.reset();
+	}
+
+	/* a message whose producer has not linked its node yet is not visible. */
+	bool empty() const { return nullptr == tail->next.load(); }
+
+	T pop(void) {
+		const auto next = tail->next.load(std::memory_order_acquire);
+		auto &value = next->value();
+		T v(std::move(value));
+		value.~T();
+		delete tail;
+		tail = next;
+		return v;
+	}
+private:
+	std::atomic<Node *> head;
+	Node *tail;
+
+	static Node *newNode(T &&v) {
+		const auto node = new Node();
+		new (&node->storage) T(std::forward<T>(v));
+		return node;
+	}
+};
+
+#endif
@@ -0,0 +1,160 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef NODE_POOL_H__
+#define NODE_POOL_H__
+
+#include <mutex>
+#include <new>
+#include <cstddef>
+
+/*
+ * Fixed size allocator for queue nodes. Every thread keeps a magazine of free nodes;
+ * full magazines are handed over to a shared depot and empty ones are refilled from it,
+ * so the mutex of the depot is taken once every MAGAZINE_SIZE operations and the
+ * heap is only used while the pool grows.
+ */
+template<typename Node>
+class NodePool {
+public:
+	NodePool() = delete;
+
+	static void *allocate(void) {
+		const auto c = cache();
+		if (nullptr == c || (0 == c->nbNodes && !depot().take(*c)))
+			return ::operator new(sizeof(Node));
+		const auto node = c->nodes;
+		c->nodes = node->next;
+		c->nbNodes--;
+		return node;
+	}
+
+	static void release(void *ptr) {
+		const auto c = cache();
+		if (nullptr == c) {
+			::operator delete(ptr);
+			return ;
+		}
+		if (MAGAZINE_SIZE == c->nbNodes)
+			depot().give(*c);
+		const auto node = static_cast<FreeNode *>(ptr);
+		node->next = c->nodes;
+		c->nodes = node;
+		c->nbNodes++;
+	}
+private:
+	static const size_t MAGAZINE_SIZE = 64;
+	static const size_t MAX_DEPOT_MAGAZINES = 256;
+
+	struct FreeNode {
+		FreeNode *next;
+		FreeNode *nextMagazine;
+	};
+	static_assert(sizeof(Node) >= sizeof(FreeNode), "node too small to be pooled.");
+
+	static void deleteNodes(FreeNode *nodes) {
+		while (nullptr != nodes) {
+			const auto node = nodes;
+			nodes = node->next;
+			::operator delete(node);
+		}
+	}
+
+	enum class CacheState { UNUSED, ALIVE, DESTROYED };
+
+	struct Magazine {
+		FreeNode *nodes;
+		size_t nbNodes;
+		Magazine() : nodes(nullptr), nbNodes(0) { cacheState() = CacheState::ALIVE; }
+		~Magazine() {
+			deleteNodes(nodes);
+			nodes = nullptr;
+			nbNodes = 0;
+			cacheState() = CacheState::DESTROYED;
+		}
+	};
+
+	class Depot {
+	public:
+		Depot() : magazines(nullptr), nbMagazines(0) { }
+
+		bool take(Magazine &m) {
+			std::unique_lock<std::mutex> l(mutex);
+
+			if (0 == nbMagazines)
+				return false;
+			m.nodes = magazines;
+			m.nbNodes = MAGAZINE_SIZE;
+			magazines = magazines->nextMagazine;
+			nbMagazines--;
+			return true;
+		}
+
+		void give(Magazine &m) {
+			std::unique_lock<std::mutex> l(mutex);
+
+			if (MAX_DEPOT_MAGAZINES == nbMagazines) {
+				l.unlock();
+				deleteNodes(m.nodes);
+			} else {
+				m.nodes->nextMagazine = magazines;
+				magazines = m.nodes;
+				nbMagazines++;
+			}
+			m.nodes = nullptr;
+			m.nbNodes = 0;
+		}
+	private:
+		std::mutex mutex;
+		FreeNode *magazines;
+		size_t nbMagazines;
+	};
+
+	/* trivially destructible: still readable while the thread_local objects of the thread are destroyed. */
+	static CacheState &cacheState(void) {
+		thread_local CacheState state = CacheState::UNUSED;
+		return state;
+	}
+
+	/* null once the magazine of the exiting thread is destroyed: the nodes then go to the heap directly. */
+	static Magazine *cache(void) {
+		if (CacheState::DESTROYED == cacheState())
+			return nullptr;
+		thread_local Magazine magazine;
+		return &magazine;
+	}
+
+	/* never destroyed: threads may still release nodes while static objects are destroyed. */
+	static Depot &depot(void) {
+		static Depot * const d = new Depot();
+		return *d;
+	}
+};
+
+#endif
@@ -0,0 +1,84 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef POOLED_EXECUTOR_H__
+#define POOLED_EXECUTOR_H__
+
+#include <actor/scheduler.h>
+#include <private/executor.h>
+#include <private/executorApi.h>
+#include <private/runnable.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+/*
+ * Executor without a thread: the link schedules it on the scheduler workers when a message is
+ * posted while it sleeps. The atStart callback runs in the constructor, or in the first turn with
+ * asyncStart.
+ * A turn processes at most messageBudget messages (0: the scheduler budget).
+ */
+class PooledExecutor : public ExecutorApi, private Runnable {
+public:
+	PooledExecutor(Scheduler &scheduler, ExecutorBody body, Link &queue,
+					ExecutorAtStart atStart = [](void) { return StatusCode::OK; }, ExecutorHook atStop = [](void) { },
+					size_t messageBudget = 0, bool asyncStart = false);
+	~PooledExecutor();
+
+	Placement getPlacement(void) override;
+	SchedulingStatistics getStatistics(void) const override;
+	bool waitTerminated(std::chrono::steady_clock::time_point deadline) override;
+
+	PooledExecutor() = delete;
+	PooledExecutor(const PooledExecutor &a) = delete;
+	PooledExecutor &operator=(const PooledExecutor &a) = delete;
+	PooledExecutor(PooledExecutor &&a) = delete;
+	PooledExecutor &operator=(PooledExecutor &&a) = delete;
+private:
+	Scheduler::SchedulerImpl &scheduler;
+	const ExecutorBody body;
+	const ExecutorAtStart atStart;
+	const ExecutorHook atStop;
+	Link &messageQueue;
+	const size_t messageBudget;
+	std::atomic<uint64_t> nbTurns;
+	std::atomic<uint64_t> nbBudgetExhausted;
+	bool started;
+	std::mutex mutex;
+	std::condition_variable terminatedCondition;
+	bool terminated;
+
+	void run(void) override;
+	bool start(void);
+	void terminate(void);
+	bool isTerminated(void);
+};
+
+#endif
@@ -33,6 +33,12 @@
 #include <private/connection.h>
 #include <actor/senderApi.h>
 
+#include <memory>
+
+/*
+ * Replies to requests come back on the connection of the proxy: they are read by a thread started
+ * at the first request and dispatched to the reply senders by correlation id.
+ */
 class ProxyClient : public SenderApi {
 public:
 	ProxyClient(std::string name, Connection connection);
@@ -40,8 +46,15 @@ public:
 
 	void post(Command command, SharedSenderLink sender = SharedSenderLink());
 	void post(Command command, const RawData &params, SharedSenderLink sender = SharedSenderLink());
+	void request(Command command, const RawData &params, SharedSenderLink replyTo) override;
+	/* requests waiting for their reply. */
+	size_t getNbPendingRequests(void) const;
 private:
-	const Connection connection;
+	struct Channel;
+
+	const std::shared_ptr<Channel> channel;
+
+	static void readReplies(std::shared_ptr<Channel> channel);
 };
 
 #endif
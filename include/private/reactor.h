@@ -0,0 +1,80 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#ifndef REACTOR_H__
+#define REACTOR_H__
+
+#include <actor/link.h>
+#include <actor/io.h>
+
+#include <mutex>
+#include <thread>
+#include <memory>
+#include <unordered_map>
+
+/*
+ * One epoll thread for all the actors, started at the first watch and stopped at exit: a ready
+ * descriptor is posted as a command to the actor watching it. A descriptor is watched in one shot
+ * mode and only armed again by the actor executor, once the command returned.
+ */
+class Reactor {
+public:
+	~Reactor();
+
+	Reactor(const Reactor &r) = delete;
+	Reactor &operator=(const Reactor &r) = delete;
+
+	/* replaces the previous watch of fd. */
+	void watch(int fd, uint32_t events, Command command, const SharedLink &link);
+	void unwatch(int fd);
+
+	static Reactor &get(void);
+private:
+	struct Watch {
+		uint32_t events;
+		Command command;
+		std::weak_ptr<Link> link;
+		uint32_t generation;
+	};
+
+	const int epollFd;
+	const int stopFd;
+	std::mutex mutex;
+	std::unordered_map<int, Watch> watches;
+	uint32_t nextGeneration;
+	std::thread thread;
+
+	Reactor();
+	void run(void);
+	void dispatch(uint64_t data, uint32_t ready);
+	void rearm(int fd, uint32_t generation);
+};
+
+#endif
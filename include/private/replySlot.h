@@ -1,4 +1,4 @@
-/* Copyright 2016 Laurent Van Begin
+/* Copyright 2017 Laurent Van Begin
  * This program is free software: you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
  * the Free Software Foundation, either version 3 of the License, or
@@ -27,57 +27,38 @@
  * OF THE POSSIBILITY OF SUCH DAMAGE.
  */
 
-#ifndef SHARED_QUEUE_H__
-#define SHARED_QUEUE_H__
+#ifndef REPLY_SLOT_H__
+#define REPLY_SLOT_H__
+
+#include <actor/senderApi.h>
 
 #include <mutex>
 #include <condition_variable>
-#include <queue>
-#include <functional>
 #include <chrono>
 
-template<typename T>
-class SharedQueue {
+/* one-shot sender: keeps the first message posted to it and ignores the next ones. */
+class ReplySlot : public SenderApi {
 public:
-	SharedQueue(std::function<T(void)> invalidValue = [](){ return T(); }) : invalidValue(invalidValue) { }
-	~SharedQueue() = default;
-
-	void post (T &&v) {
-		std::unique_lock<std::mutex> l(mutexQueue);
+	ReplySlot();
+	~ReplySlot();
 
-		q.push(std::forward<T>(v));
-		condition.notify_one();
-	}
-	T get(void) {
-		return get([this](std::unique_lock<std::mutex> &l) { 
-			condition.wait(l, [this]() { return !q.empty();}); 
-			return true;
-		});
-	}
+	void post(Command command, SharedSenderLink sender = SharedSenderLink()) override;
+	void post(Command command, const RawData &data, SharedSenderLink sender = SharedSenderLink()) override;
 
-	T get (unsigned int timeout_in_ms) {
-		std::chrono::milliseconds timeout(timeout_in_ms);
-		return get([this, &timeout](std::unique_lock<std::mutex> &l) { 
-			return condition.wait_for(l, timeout, [this]() { return !q.empty();}); 
-		});
-	}
+	bool wait(std::chrono::steady_clock::time_point deadline);
+	/* returns false when the reply is already there: the callback is then not kept. */
+	bool onReply(std::function<void(void)> callback);
+	void expire(void);
+	bool isReady(void);
+	Command getCommand(void);
+	RawData getData(void);
 private:
-	using WaitMessage = std::function<bool(std::unique_lock<std::mutex> &)> ;
-
-	T get(WaitMessage &&waitMessage) {
-		std::unique_lock<std::mutex> l(mutexQueue);
-
-		if (!waitMessage(l)) 
-			return invalidValue();	
-		auto message = std::move(q.front());
-		q.pop();
-		return message;
-		
-	}
-	std::mutex mutexQueue;
-	std::condition_variable condition;
-	std::queue<T> q;
-	std::function<T(void)> invalidValue;
+	std::mutex mutex;
+	std::condition_variable repliedCondition;
+	bool replied;
+	std::function<void(void)> callback;
+	Command command;
+	RawData data;
 };
 
 #endif
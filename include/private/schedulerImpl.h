@@ -0,0 +1,110 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef SCHEDULER_IMPL_H__
+#define SCHEDULER_IMPL_H__
+
+#include <actor/scheduler.h>
+#include <private/runnable.h>
+#include <private/workStealingDeque.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <memory>
+
+/*
+ * Each worker owns a work-stealing deque: an actor woken up by a post from a worker runs on that
+ * worker, other posts go through a shared injection queue. Idle workers steal before parking.
+ * A worker also polls the injection queue every INJECTION_POLL_INTERVAL runnables: actors that
+ * keep waking each other up on a worker do not starve the actors posted from other threads.
+ */
+class Scheduler::SchedulerImpl {
+public:
+	SchedulerImpl(unsigned int nbWorkers, const CpuSet &cpus, size_t messageBudget);
+	~SchedulerImpl();
+
+	SchedulerImpl(const SchedulerImpl &s) = delete;
+	SchedulerImpl &operator=(const SchedulerImpl &s) = delete;
+
+	void schedule(Runnable &runnable);
+	/*
+	 * called by a runnable that used its budget: it goes to the injection queue, behind the runnables
+	 * already injected, so that it runs again within INJECTION_POLL_INTERVAL picks of a worker.
+	 */
+	void yield(Runnable &runnable);
+	/* lets a worker waiting for another runnable execute pending work instead of blocking the pool. */
+	bool runPending(void);
+	bool isWorkerThread(void) const;
+	unsigned int getNbWorkers(void) const;
+	Placement getPlacement(void) const;
+	size_t getMessageBudget(void) const;
+	SchedulingStatistics getStatistics(void) const;
+private:
+	struct Worker {
+		const size_t index;
+		const CpuSet cpus;
+		WorkStealingDeque<Runnable *> runQueue;
+		std::thread thread;
+		std::atomic<uint64_t> nbTurns;
+		std::atomic<uint64_t> nbBudgetExhausted;
+		/* only used by the thread of the worker. */
+		unsigned int nbPicks;
+		Worker(size_t index, CpuSet cpus) : index(index), cpus(std::move(cpus)), nbTurns(0), nbBudgetExhausted(0),
+											nbPicks(0) { }
+	};
+
+	static const unsigned int INJECTION_POLL_INTERVAL = 61;
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<Runnable *> injectionQueue;
+	std::atomic<size_t> nbInjected;
+	std::atomic<unsigned int> nbSleeping;
+	bool stopping;
+	const size_t messageBudget;
+	std::vector<std::unique_ptr<Worker>> workers;
+
+	static thread_local Worker *currentWorker;
+
+	void work(Worker &self);
+	void inject(Runnable &runnable);
+	void run(Worker &self, Runnable &runnable);
+	Runnable *next(Worker &self);
+	Runnable *takeInjected(void);
+	Runnable *steal(const Worker &self);
+	bool park(void);
+	bool hasWork(void) const;
+	void wakeUpSleeping(void);
+};
+
+#endif
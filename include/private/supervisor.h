@@ -51,6 +51,8 @@ public:
 	void removeActor(const std::string &name);
 	void registerMonitored(Supervisor &monitored);
 	void unregisterMonitored(Supervisor &monitored);
+	/* null when nobody supervises the actor. */
+	SharedLink getSupervisorLink(void) const;
 private:
 	mutable std::mutex monitorMutex;
 	const ErrorActionDispatcher actionDispatcher;
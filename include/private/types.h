@@ -33,7 +33,7 @@
 #include <actor/types.h>
 #include <actor/rawData.h>
 
-enum class MessageType:uint32_t { COMMAND_MESSAGE, ERROR_MESSAGE, MANAGEMENT_MESSAGE, };
+enum class MessageType:uint32_t { COMMAND_MESSAGE, ERROR_MESSAGE, MANAGEMENT_MESSAGE, DEFERRED_MESSAGE, };
 
 using Id = uint32_t;
 
@@ -42,6 +42,6 @@ static inline Id toId(const RawData &data)
 	return data.toInt();
 }
 
-enum class postType : uint32_t { NewMessage = 0xFFFFFFFF, } ;
+enum class postType : uint32_t { NewMessage = 0xFFFFFFFF, NewRequest = 0xFFFFFFFE, Reply = 0xFFFFFFFD, } ;
 
 #endif
@@ -0,0 +1,125 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef WORK_STEALING_DEQUE_H__
+#define WORK_STEALING_DEQUE_H__
+
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+
+/*
+ * Chase-Lev deque (with the memory orderings of Le et al., PPoPP 2013): the owner pushes and pops at
+ * the bottom without contention, other threads steal the oldest element at the top.
+ * Arrays outgrown by the owner are kept until destruction since a thief may still read them.
+ */
+template<typename T>
+class WorkStealingDeque {
+public:
+	/* the capacity must be a power of two. */
+	explicit WorkStealingDeque(size_t initialCapacity = 64) : top(0), bottom(0) {
+		arrays.emplace_back(new Array(initialCapacity));
+		array = arrays.back().get();
+	}
+	~WorkStealingDeque() = default;
+
+	WorkStealingDeque(const WorkStealingDeque &d) = delete;
+	WorkStealingDeque &operator=(const WorkStealingDeque &d) = delete;
+
+	/* owner only. */
+	void push(T v) {
+		const auto b = bottom.load(std::memory_order_relaxed);
+		const auto t = top.load(std::memory_order_acquire);
+		auto a = array.load(std::memory_order_relaxed);
+		if (b - t >= static_cast<int64_t>(a->capacity))
+			a = grow(a, t, b);
+		a->put(b, v);
+		std::atomic_thread_fence(std::memory_order_release);
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+
+	/* owner only: the newest element first. */
+	bool pop(T &v) {
+		const auto b = bottom.load(std::memory_order_relaxed) - 1;
+		const auto a = array.load(std::memory_order_relaxed);
+		bottom.store(b, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		auto t = top.load(std::memory_order_relaxed);
+		if (t > b) {
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return false;
+		}
+		v = a->get(b);
+		if (t == b) {
+			const auto won = top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+			bottom.store(b + 1, std::memory_order_relaxed);
+			return won;
+		}
+		return true;
+	}
+
+	/* any thread: the oldest element first. Fails as well when another thread won the race. */
+	bool steal(T &v) {
+		auto t = top.load(std::memory_order_acquire);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		const auto b = bottom.load(std::memory_order_acquire);
+		if (t >= b)
+			return false;
+		v = array.load(std::memory_order_acquire)->get(t);
+		return top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+	}
+
+	bool empty(void) const { return bottom.load() <= top.load(); }
+private:
+	struct Array {
+		const size_t capacity;
+		std::unique_ptr<std::atomic<T>[]> elements;
+
+		explicit Array(size_t capacity) : capacity(capacity), elements(new std::atomic<T>[capacity]) { }
+		T get(int64_t i) const { return elements[i & (capacity - 1)].load(std::memory_order_relaxed); }
+		void put(int64_t i, T v) { elements[i & (capacity - 1)].store(v, std::memory_order_relaxed); }
+	};
+
+	Array *grow(Array *a, int64_t t, int64_t b) {
+		arrays.emplace_back(new Array(2 * a->capacity));
+		auto bigger = arrays.back().get();
+		for (auto i = t; i < b; i++)
+			bigger->put(i, a->get(i));
+		array.store(bigger, std::memory_order_release);
+		return bigger;
+	}
+
+	std::atomic<int64_t> top;
+	std::atomic<int64_t> bottom;
+	std::atomic<Array *> array;
+	std::vector<std::unique_ptr<Array>> arrays;
+};
+
+#endif
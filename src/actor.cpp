@@ -33,14 +33,22 @@
 #include <private/exception.h>
 #include <private/actorController.h>
 #include <private/executor.h>
+#include <private/pooledExecutor.h>
+#include <private/cpuAffinity.h>
+#include <private/deferredTask.h>
 #include <private/actorStateMachine.h>
 #include <private/actorContext.h>
 
 #include <mutex>
-#include <future>
+#include <condition_variable>
 #include <memory>
 #include <iostream>
 #include <exception>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <unordered_map>
+#include <unordered_set>
 
 class ActorException : public std::runtime_error {
 	public:
@@ -57,19 +65,30 @@ class ActorException : public std::runtime_error {
 class Actor::ActorImpl {
 public:
 	ActorImpl(std::string name, CommandExecutor commandExecutor, ActorHooks hooks, std::unique_ptr<State> state,
-			ErrorActionDispatcher errorDispatcher) :
-				executorQueue(Link::create(std::move(name))),
+			ErrorActionDispatcher errorDispatcher, ActorOptions options) :
+				executorQueue(Link::create(std::move(name), options.mailBox)),
 				hooks(hooks), commandExecutor(std::move(commandExecutor)),
-				context(errorDispatcher, executorQueue,	std::move(state)),
-				executor(createAtStartExecutor())
-				{ checkActorInitialization(); }
+				context(errorDispatcher, executorQueue,	std::move(state)), scheduler(std::move(options.scheduler)),
+				cpus(std::move(options.cpus)), messageBudget(options.messageBudget), asyncStart(options.asyncStart),
+				idleTimeout(options.idleTimeout),
+				executor(createAtStartExecutor()), nbShutdowns(0)
+				{
+					if (!asyncStart)
+						checkActorInitialization();
+					std::unique_lock<std::mutex> l(directory().mutex);
+					directory().actors.insert(this);
+				}
 	~ActorImpl() {
+		std::unique_lock<std::mutex> l(directory().mutex);
+		directory().released.wait(l, [this]() { return 0 == nbShutdowns; });
+		directory().actors.erase(this);
+		l.unlock();
 		stateMachine.moveTo(ActorStateMachine::State::STOPPED);
 		context.getConstSupervisor().notifySupervisor(InternalCommands::UNREGISTER_ACTOR);
-		executorQueue->post(InternalCommands::SHUTDOWN);
+		executorQueue->post(MessageType::MANAGEMENT_MESSAGE, InternalCommands::SHUTDOWN);
 	}
 
-	std::unique_ptr<Executor> createAtStartExecutor() {
+	std::unique_ptr<ExecutorApi> createAtStartExecutor() {
 		return createExecutor([this]() { return executorStartCb(hooks.atStart); });
 	}
 
@@ -82,15 +101,6 @@ public:
 		return (this->stateMachine.moveTo(nextState), rc);
 	}
 
-	StatusCode executorRestartCb(std::promise<StatusCode> &status, std::promise<std::unique_ptr<Executor> &> &e) {
-		std::unique_ptr<Executor> ref(std::move(e.get_future().get()));
-		std::swap(executor, ref);
-		initContextState();
-		const auto rc = hooks.atRestart(context);
-		status.set_value(rc);
-		return  rc;
-	}
-
 	void executorStopCb(void) {
 		static const ActorStateMachine::State stateValues [] = { ActorStateMachine::State::STOPPED,
 																ActorStateMachine::State::ERROR };
@@ -99,6 +109,15 @@ public:
 			hooks.atStop(context);
 	}
 
+	/* an actor being stopped does not hibernate nor wake up anymore. */
+	void executorIdleCb(const std::function<void(const Context &)> &hook) {
+		static const ActorStateMachine::State runningValue[] = { ActorStateMachine::State::RUNNING };
+		static const std::vector<ActorStateMachine::State> running(runningValue, runningValue +
+																			sizeof(runningValue) / sizeof(runningValue[0]));
+		if (stateMachine.isIn(running))
+			hook(context);
+	}
+
 	void initContextState() { context.getState().init(executorQueue->getName()); }
 
 
@@ -113,12 +132,14 @@ public:
 				return (context.getConstSupervisor().manageErrorFromSupervised(command, params), StatusCode::OK);
 			case MessageType::MANAGEMENT_MESSAGE:
 				return executeActorManagement(command, params);
-			case MessageType::COMMAND_MESSAGE: {
-				const auto status = executeActorBody(command, params, sender);
-				if (StatusCode::SHUTDOWN == status)
-					stateMachine.moveTo(ActorStateMachine::State::STOPPED);
-				return status;
-			}
+			case MessageType::COMMAND_MESSAGE:
+				return stopOnShutdown(executeActorBody([this, command, &params, &sender]() {
+					return commandExecutor.execute(context, command, params, sender);
+				}));
+			case MessageType::DEFERRED_MESSAGE:
+				return stopOnShutdown(executeActorBody([&sender]() {
+					return static_cast<const DeferredTask &>(*sender).run();
+				}));
 			default:
 				std::cerr << "Unknown Message type in " << __PRETTY_FUNCTION__ << std::endl;
 				return StatusCode::ERROR;
@@ -129,7 +150,7 @@ public:
 	StatusCode executeActorManagement(Command command, const RawData &params) {
 		switch (command) {
 			case InternalCommands::RESTART:
-				return (StatusCode::OK == restartSateMachine()) ? StatusCode::SHUTDOWN : StatusCode::ERROR;
+				return restartSateMachine();
 			case InternalCommands::UNREGISTER_ACTOR:
 				context.getSupervisor().removeActor(params.toString());
 				return StatusCode::OK;
@@ -142,30 +163,41 @@ public:
 		}
 	}
 
+	/* the actor restarts on its current executor: a failed restart stops it. */
 	StatusCode restartSateMachine(void) {
 		stateMachine.moveTo(ActorStateMachine::State::RESTARTING);
-	    const auto nextState = (StatusCode::OK == restartExecutor()) ? ActorStateMachine::State::RUNNING :
-	    															ActorStateMachine::State::ERROR;
-		return (stateMachine.moveTo(nextState), StatusCode::OK);
+		initContextState();
+		const auto rc = hooks.atRestart(context);
+	    const auto nextState = (StatusCode::OK == rc) ? ActorStateMachine::State::RUNNING :
+	    												ActorStateMachine::State::ERROR;
+		stateMachine.moveTo(nextState);
+		return (StatusCode::OK == rc) ? StatusCode::OK : StatusCode::SHUTDOWN;
 	}
 
-	StatusCode restartExecutor(void) {
-		std::promise<StatusCode> status;
-		std::promise<std::unique_ptr<Executor> &> e;
-		auto newExecutor = createExecutor([this, &status, & e]() { return executorRestartCb(status, e); });
-		e.set_value(newExecutor);
-		return status.get_future().get();
+	std::unique_ptr<ExecutorApi> createExecutor(ExecutorAtStart atStartCb) {
+		const ExecutorBody body = [this](auto type, auto command, auto &params, auto &sender)
+										{ return this->actorExecutor(type, command, params, sender); };
+		const ExecutorHook atStop = [this]() { executorStopCb(); };
+		if (nullptr == scheduler) {
+			const Hibernation hibernation(idleTimeout, [this]() { executorIdleCb(hooks.atHibernate); },
+											[this]() { executorIdleCb(hooks.atWake); });
+			return (checkCpuSet(cpus), std::make_unique<Executor>(body, *executorQueue, atStartCb, atStop, cpus,
+																	hibernation));
+		}
+		return std::make_unique<PooledExecutor>(*scheduler, body, *executorQueue, atStartCb, atStop, messageBudget,
+												asyncStart);
 	}
 
-	std::unique_ptr<Executor> createExecutor(ExecutorAtStart atStartCb) {
-	return std::make_unique<Executor>( [this](auto type, auto command, auto &params, auto &sender)
-			{ return this->actorExecutor(type, command, params, sender); }, *executorQueue,
-				atStartCb, [this]() { executorStopCb(); } );
+	StatusCode stopOnShutdown(StatusCode status) {
+		if (StatusCode::SHUTDOWN == status)
+			stateMachine.moveTo(ActorStateMachine::State::STOPPED);
+		return status;
 	}
 
-	StatusCode executeActorBody(Command command, const RawData &params, const SharedSenderLink &sender) {
+	template<typename Body>
+	StatusCode executeActorBody(Body body) {
 		try {
-			const auto rc = commandExecutor.execute(context, command, params, sender);
+			const auto rc = body();
 			if (StatusCode::ERROR != rc)
 				return rc;
 			throw std::runtime_error("Actor command terminated on error.");
@@ -178,6 +210,35 @@ public:
 		}
 	}
 
+	/*
+	 * the directory is only locked to take the actors: the actors destroyed during a shutdown wait until
+	 * it ends, the others are created or destroyed meanwhile.
+	 */
+	static ShutdownReport shutdown(const ActorImpl *root, unsigned int deadline_in_ms) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(deadline_in_ms);
+		std::unique_lock<std::mutex> l(directory().mutex);
+		const auto actors = (nullptr == root) ? std::vector<ActorImpl *>(directory().actors.begin(),
+																		directory().actors.end()) :
+												supervisionTree(*root);
+		for (const auto a : actors)
+			a->nbShutdowns++;
+		l.unlock();
+		for (const auto a : actors)
+			a->executorQueue->post(MessageType::MANAGEMENT_MESSAGE, InternalCommands::SHUTDOWN);
+		ShutdownReport report;
+		for (const auto a : actors) {
+			if (a->executor->waitTerminated(deadline))
+				report.nbStopped++;
+			else
+				report.stragglers.push_back(a->executorQueue->getName());
+		}
+		l.lock();
+		for (const auto a : actors)
+			a->nbShutdowns--;
+		directory().released.notify_all();
+		return report;
+	}
+
 	void checkActorInitialization(void) const {
 		if (ActorStateMachine::State::STOPPED == stateMachine.waitStarted())
 			throw ActorStartFailure();
@@ -188,7 +249,49 @@ public:
 	const CommandExecutor commandExecutor;
 	ActorContext context;
 	ActorStateMachine stateMachine;
-	std::unique_ptr<Executor> executor;
+	const SharedScheduler scheduler;
+	const CpuSet cpus;
+	const size_t messageBudget;
+	const bool asyncStart;
+	const unsigned int idleTimeout;
+	const std::unique_ptr<ExecutorApi> executor;
+	/* shutdowns using this actor, under the directory mutex. */
+	size_t nbShutdowns;
+
+	/* every live actor. Never destroyed: static actors may be destroyed after it. */
+	struct Directory {
+		std::mutex mutex;
+		/* notified when a shutdown releases its actors. */
+		std::condition_variable released;
+		std::unordered_set<ActorImpl *> actors;
+	};
+
+	static Directory &directory(void) {
+		static Directory * const d = new Directory();
+		return *d;
+	}
+
+	/* breadth first from the root, built from the supervisor of each live actor. */
+	static std::vector<ActorImpl *> supervisionTree(const ActorImpl &root) {
+		std::unordered_map<const Link *, ActorImpl *> byLink;
+		for (const auto a : directory().actors)
+			byLink[a->executorQueue.get()] = a;
+		std::unordered_map<const ActorImpl *, std::vector<ActorImpl *>> supervised;
+		for (const auto a : directory().actors) {
+			const auto supervisor = byLink.find(a->context.getConstSupervisor().getSupervisorLink().get());
+			if (byLink.end() != supervisor)
+				supervised[supervisor->second].push_back(a);
+		}
+		std::vector<ActorImpl *> tree = { const_cast<ActorImpl *>(&root) };
+		std::unordered_set<const ActorImpl *> visited = { &root };
+		for (size_t i = 0; i < tree.size(); i++) {
+			for (const auto a : supervised[tree[i]]) {
+				if (visited.insert(a).second)
+					tree.push_back(a);
+			}
+		}
+		return tree;
+	}
 };
 
 const AtStartHook DEFAULT_START_HOOK = [](const Context&) { return StatusCode::OK; };
@@ -197,6 +300,8 @@ const AtRestartHook DEFAULT_RESTART_HOOK = [](const Context& c) {
 	c.restartActors();
 	return StatusCode::OK;
 };
+const AtHibernateHook DEFAULT_HIBERNATE_HOOK = [](const Context &) { };
+const AtWakeHook DEFAULT_WAKE_HOOK = [](const Context &) { };
 const ErrorActionDispatcher DEFAULT_ERROR_DISPATCHER = [](ErrorCode) { return ErrorReactionFactory::restartActor(); };
 static const ActorHooks DEFAULT_HOOKS = ActorHooks(DEFAULT_START_HOOK, DEFAULT_STOP_HOOK, DEFAULT_RESTART_HOOK);
 
@@ -211,10 +316,15 @@ Actor::Actor(std::string name, CommandExecutor commandExecutor, std::unique_ptr<
 						Actor(std::move(name), std::move(commandExecutor), DEFAULT_HOOKS, std::move(state), errorDispatcher) { }
 
 Actor::Actor(std::string name, CommandExecutor commandExecutor, ActorHooks hooks, std::unique_ptr<State> state,
-				ErrorActionDispatcher errorDispatcher) :
-					pImpl(new Actor::ActorImpl(name, std::move(commandExecutor), hooks, std::move(state), errorDispatcher))
+				ErrorActionDispatcher errorDispatcher, ActorOptions options) :
+					pImpl(new Actor::ActorImpl(name, std::move(commandExecutor), hooks, std::move(state), errorDispatcher,
+												options))
 										{ }
 
+Actor::Actor(std::string name, CommandExecutor commandExecutor, ActorOptions options, ErrorActionDispatcher errorDispatcher) :
+		Actor(std::move(name), std::move(commandExecutor), DEFAULT_HOOKS, std::make_unique<NoState>(), errorDispatcher,
+				options) { }
+
 Actor::~Actor() { delete pImpl; }
 
 
@@ -227,8 +337,79 @@ void Actor::post(Command command, const RawData &params, SharedSenderLink sender
 	pImpl->executorQueue->post(command, params, std::move(sender));
 }
 
+void Actor::post(Command command, RawData &&params, SharedSenderLink sender) const {
+	pImpl->executorQueue->post(command, std::move(params), std::move(sender));
+}
+
+void Actor::post(std::initializer_list<PostedCommand> commands, SharedSenderLink sender) const {
+	pImpl->executorQueue->post(commands, std::move(sender));
+}
+
+void Actor::post(const std::vector<PostedCommand> &commands, SharedSenderLink sender) const {
+	pImpl->executorQueue->post(commands, std::move(sender));
+}
+
+PostStatus Actor::tryPost(Command command, SharedSenderLink sender) const {
+	return pImpl->executorQueue->tryPost(command, std::move(sender));
+}
+
+PostStatus Actor::tryPost(Command command, const RawData &params, SharedSenderLink sender) const {
+	return pImpl->executorQueue->tryPost(command, params, std::move(sender));
+}
+
+void Actor::waitStarted(void) const { pImpl->checkActorInitialization(); }
+
+void Actor::watch(int fd, uint32_t events, Command command) const { pImpl->context.watch(fd, events, command); }
+
+void Actor::unwatch(int fd) const { pImpl->context.unwatch(fd); }
+
+ShutdownReport Actor::shutdown(unsigned int deadline_in_ms) const { return ActorImpl::shutdown(pImpl, deadline_in_ms); }
+
+ShutdownReport Actor::shutdownAll(unsigned int deadline_in_ms) { return ActorImpl::shutdown(nullptr, deadline_in_ms); }
+
+std::vector<std::unique_ptr<Actor>> Actor::spawnAll(size_t nbActors, ActorFactory factory, ActorOptions options) {
+	options.asyncStart = true;
+	std::vector<std::unique_ptr<Actor>> actors(nbActors);
+	const auto nbSpawners = std::min<size_t>(nbActors, std::max(1u, std::thread::hardware_concurrency()));
+	std::vector<std::exception_ptr> failures(nbSpawners);
+	const auto spawn = [nbActors, nbSpawners, &actors, &failures, &factory, &options](size_t spawner) {
+		try {
+			for (auto i = spawner; i < nbActors; i += nbSpawners)
+				actors[i] = factory(i, options);
+		} catch (...) {
+			failures[spawner] = std::current_exception();
+		}
+	};
+	std::vector<std::thread> spawners;
+	for (size_t spawner = 1; spawner < nbSpawners; spawner++)
+		spawners.emplace_back(spawn, spawner);
+	if (0 < nbSpawners)
+		spawn(0);
+	for (auto &t : spawners)
+		t.join();
+	for (const auto &failure : failures) {
+		if (failure)
+			std::rethrow_exception(failure);
+	}
+	for (const auto &a : actors)
+		a->waitStarted();
+	return actors;
+}
+
+Reply Actor::ask(Command command, unsigned int timeout_in_ms) const {
+	return pImpl->executorQueue->ask(command, timeout_in_ms);
+}
+
+Reply Actor::ask(Command command, const RawData &params, unsigned int timeout_in_ms) const {
+	return pImpl->executorQueue->ask(command, params, timeout_in_ms);
+}
+
 SharedSenderLink Actor::getActorLinkRef() const { return pImpl->executorQueue; }
 
+Placement Actor::getPlacement(void) const { return pImpl->executor->getPlacement(); }
+
+SchedulingStatistics Actor::getStatistics(void) const { return pImpl->executor->getStatistics(); }
+
 void Actor::registerActor(Actor &monitored) {
 	pImpl->context.getSupervisor().registerMonitored(monitored.pImpl->context.getSupervisor());
 }
@@ -28,9 +28,10 @@
  */
 
 #include <private/actorContext.h>
+#include <private/reactor.h>
 
 ActorContext::ActorContext(ErrorActionDispatcher strategy, SharedLink self, std::unique_ptr<State> state) :
-				state(std::move(state)), supervisor(strategy, self) { }
+				self(self), state(std::move(state)), supervisor(strategy, self) { }
 
 ActorContext::~ActorContext() = default;
 
@@ -48,6 +49,17 @@ void ActorContext::stopActors() const { getConstSupervisor().stopActors(); }
 
 State &ActorContext::getState() { return *state; }
 
+std::function<void(void)> ActorContext::continuation(ContinuationTask task) const {
+	const auto link = self;
+	return [link, task]() { link->defer(task); };
+}
+
+void ActorContext::watch(int fd, uint32_t events, Command command) const {
+	Reactor::get().watch(fd, events, command, self);
+}
+
+void ActorContext::unwatch(int fd) const { Reactor::get().unwatch(fd); }
+
 Supervisor &ActorContext::getSupervisor() { return supervisor; }
 
 const Supervisor &ActorContext::getConstSupervisor() const { return supervisor; }
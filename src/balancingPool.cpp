@@ -0,0 +1,180 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <actor/balancingPool.h>
+#include <actor/link.h>
+#include <private/exception.h>
+
+#include <algorithm>
+#include <mutex>
+#include <utility>
+
+/*
+ * The messages wait in the shared link until a member pulls them. A member pulls one message at a
+ * time: the message and the next pull are forced in its own mailbox, so the pull runs on the member
+ * right after the command and never waits for room. A member finding the shared link empty goes idle
+ * until the next post. A restarted member keeps its mailbox; a stopped one is never picked anymore and
+ * gives back the commands it did not process.
+ */
+class BalancingPool::PoolLink : public SenderApi, public std::enable_shared_from_this<PoolLink> {
+public:
+	PoolLink(std::string name) : SenderApi(name), backlog(Link::create(std::move(name))) { }
+	~PoolLink() = default;
+
+	void post(Command command, SharedSenderLink sender) override {
+		backlog->post(command, std::move(sender));
+		dispatch();
+	}
+
+	void post(Command command, const RawData &params, SharedSenderLink sender) override {
+		backlog->post(command, params, std::move(sender));
+		dispatch();
+	}
+
+	/* the backlog is unbounded: the messages never wait for a member. */
+	PostStatus tryPost(Command command, const RawData &params, SharedSenderLink sender) override {
+		const auto status = backlog->tryPost(command, params, std::move(sender));
+		if (PostStatus::FULL != status)
+			dispatch();
+		return status;
+	}
+
+	void addMembers(const std::vector<std::unique_ptr<Actor>> &actors) {
+		std::unique_lock<std::mutex> l(mutex);
+		for (const auto &a : actors)
+			/* the link of an actor is its mailbox. */
+			members.push_back(std::static_pointer_cast<Link>(a->getActorLinkRef()));
+		for (size_t i = 0; i < members.size(); i++)
+			pullOn(i);
+	}
+
+	ActorHooks memberHooks(size_t member) {
+		const std::weak_ptr<PoolLink> pool = shared_from_this();
+		return ActorHooks(DEFAULT_START_HOOK, [pool, member](const Context &c) {
+			DEFAULT_STOP_HOOK(c);
+			const auto p = pool.lock();
+			if (nullptr != p)
+				p->memberStopped(member);
+		}, DEFAULT_RESTART_HOOK);
+	}
+
+private:
+	const SharedLink backlog;
+	std::vector<SharedLink> members;
+	std::mutex mutex;
+	std::vector<size_t> idleMembers;
+
+	void dispatch(void) {
+		std::unique_lock<std::mutex> l(mutex);
+		if (idleMembers.empty())
+			return ;
+		const auto member = idleMembers.back();
+		idleMembers.pop_back();
+		pullOn(member);
+	}
+
+	/* under the mutex: once a stopped member left idleMembers, it does not get any pull anymore. */
+	void pullOn(size_t member) {
+		const std::weak_ptr<PoolLink> pool = shared_from_this();
+		members[member]->defer([pool, member]() {
+			const auto p = pool.lock();
+			return (nullptr == p) ? StatusCode::OK : p->pull(member);
+		});
+	}
+
+	/* the link is a single consumer queue: the members take turns under the mutex. */
+	StatusCode pull(size_t member) {
+		std::unique_lock<std::mutex> l(mutex);
+		if (!backlog->hasMessage()) {
+			idleMembers.push_back(member);
+			return StatusCode::OK;
+		}
+		members[member]->forcePost(backlog->get());
+		pullOn(member);
+		return StatusCode::OK;
+	}
+
+	/* runs on the member once it stopped processing its mailbox: what is left there is drained. */
+	void memberStopped(size_t member) {
+		std::unique_lock<std::mutex> l(mutex);
+		if (members.size() <= member)
+			return ;
+		idleMembers.erase(std::remove(idleMembers.begin(), idleMembers.end(), member), idleMembers.end());
+		const auto &link = members[member];
+		while (link->hasMessage()) {
+			auto message = link->get();
+			if (MessageType::COMMAND_MESSAGE == message.type)
+				backlog->forcePost(std::move(message));
+		}
+		l.unlock();
+		dispatch();
+	}
+};
+
+static std::vector<std::unique_ptr<Actor>> spawnMembers(const std::string &name, size_t nbMembers,
+														CommandExecutorFactory factory, ActorOptions options,
+														std::function<ActorHooks(size_t)> hooks) {
+	if (0 == nbMembers)
+		THROW(std::runtime_error, "a balancing pool needs at least one member.");
+	return Actor::spawnAll(nbMembers, [&name, &factory, &hooks](size_t index, const ActorOptions &options) {
+		return std::make_unique<Actor>(name + "/" + std::to_string(index), factory(index), hooks(index),
+										std::make_unique<NoState>(), DEFAULT_ERROR_DISPATCHER, options);
+	}, std::move(options));
+}
+
+BalancingPool::BalancingPool(std::string name, size_t nbMembers, CommandExecutorFactory factory,
+								ActorOptions options) :
+				link(std::make_shared<PoolLink>(name)),
+				members(spawnMembers(name, nbMembers, std::move(factory), std::move(options),
+									[this](size_t index) { return link->memberHooks(index); })) {
+	link->addMembers(members);
+}
+
+BalancingPool::~BalancingPool() = default;
+
+void BalancingPool::post(Command command, SharedSenderLink sender) const { link->post(command, std::move(sender)); }
+
+void BalancingPool::post(Command command, const RawData &params, SharedSenderLink sender) const {
+	link->post(command, params, std::move(sender));
+}
+
+Reply BalancingPool::ask(Command command, unsigned int timeout_in_ms) const { return link->ask(command, timeout_in_ms); }
+
+Reply BalancingPool::ask(Command command, const RawData &params, unsigned int timeout_in_ms) const {
+	return link->ask(command, params, timeout_in_ms);
+}
+
+const std::string &BalancingPool::getName(void) const { return link->getName(); }
+
+SharedSenderLink BalancingPool::getActorLinkRef() const { return link; }
+
+size_t BalancingPool::getNbMembers(void) const { return members.size(); }
+
+Actor &BalancingPool::getMember(size_t index) const { return *members.at(index); }
@@ -63,8 +63,8 @@ const Connection &Connection::writeRawData(const RawData &data) const {
 
 RawData Connection::readRawData(void) const {
 	RawData data(readInt<size_t>());
-	if (0 < data.capacity())
-		readBytesNonBlocking(data.data(), data.capacity());
+	if (0 < data.size())
+		readBytesNonBlocking(data.data(), data.size());
 	return data;
 }
 
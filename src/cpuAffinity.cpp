@@ -0,0 +1,111 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <private/cpuAffinity.h>
+
+#include <string>
+#include <pthread.h>
+#include <sched.h>
+#include <dirent.h>
+
+#ifdef __linux__
+
+static const std::string NODE_PREFIX("node");
+
+static cpu_set_t toCpuSetT(const CpuSet &cpus) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (auto cpu : cpus)
+		CPU_SET(cpu, &set);
+	return set;
+}
+
+/* the kernel does not export the NUMA topology through a system call without libnuma. */
+static bool numaNodeOf(unsigned int cpu, unsigned int &node) {
+	const auto path = std::string("/sys/devices/system/cpu/cpu") + std::to_string(cpu);
+	const auto dir = opendir(path.c_str());
+	if (nullptr == dir)
+		return false;
+	auto found = false;
+	for (auto entry = readdir(dir); !found && nullptr != entry; entry = readdir(dir)) {
+		const std::string name(entry->d_name);
+		if (0 == name.compare(0, NODE_PREFIX.size(), NODE_PREFIX) && NODE_PREFIX.size() < name.size()) {
+			node = std::stoul(name.substr(NODE_PREFIX.size()));
+			found = true;
+		}
+	}
+	closedir(dir);
+	return found;
+}
+
+/* CPU ids can be sparse: offline CPUs, restricted cpuset. */
+void checkCpuSet(const CpuSet &cpus) {
+	cpu_set_t allowed;
+	const auto known = (0 == sched_getaffinity(0, sizeof(allowed), &allowed));
+	for (auto cpu : cpus) {
+		if (static_cast<unsigned int>(CPU_SETSIZE) <= cpu || (known && !CPU_ISSET(cpu, &allowed)))
+			throw InvalidCpuSet();
+	}
+}
+
+void pinCurrentThread(const CpuSet &cpus) {
+	if (cpus.empty())
+		return ;
+	const auto set = toCpuSetT(cpus);
+	pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+}
+
+Placement getThreadPlacement(std::thread::native_handle_type thread) {
+	Placement placement;
+	cpu_set_t set;
+	if (0 != pthread_getaffinity_np(thread, sizeof(set), &set))
+		return placement;
+	for (unsigned int cpu = 0; cpu < static_cast<unsigned int>(CPU_SETSIZE); cpu++) {
+		if (!CPU_ISSET(cpu, &set))
+			continue;
+		placement.cpus.insert(cpu);
+		unsigned int node;
+		if (numaNodeOf(cpu, node))
+			placement.numaNodes.insert(node);
+	}
+	return placement;
+}
+
+#else
+
+void checkCpuSet(const CpuSet &cpus) {
+	if (!cpus.empty())
+		throw InvalidCpuSet();
+}
+
+void pinCurrentThread(const CpuSet &) { }
+
+Placement getThreadPlacement(std::thread::native_handle_type) { return Placement(); }
+
+#endif
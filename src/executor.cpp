@@ -30,24 +30,133 @@
 #include <private/executor.h>
 #include <private/exception.h>
 #include <private/internalCommands.h>
+#include <private/cpuAffinity.h>
+#include <actor/timer.h>
 
-Executor::Executor(ExecutorBody body, Link &queue, ExecutorAtStart atStart, ExecutorHook atStop) :
-				messageQueue(queue), thread([this, body, atStart, atStop]() { run(body, atStart, atStop); }) { }
+#include <chrono>
 
-Executor::~Executor() { thread.join(); };
+Executor::Executor(ExecutorBody body, Link &queue, ExecutorAtStart atStart, ExecutorHook atStop, CpuSet cpus,
+					Hibernation hibernation) :
+				body(body), messageQueue(queue), atStop(atStop), cpus(cpus), hibernation(hibernation), woken(false),
+				hibernated(false), resuming(false), terminated(false) {
+	if (0 != hibernation.idleTimeout)
+		messageQueue.setWakeUp([this]() { wakeUp(); });
+	std::unique_lock<std::mutex> l(mutex);
+	thread = std::thread([this, atStart]() { run(atStart); });
+}
+
+/* the actor posted the shutdown before: no thread is started anymore once a pending resume is done. */
+Executor::~Executor() {
+	std::unique_lock<std::mutex> l(mutex);
+	resumedCondition.wait(l, [this]() { return !resuming; });
+	auto last = std::move(thread);
+	l.unlock();
+	last.join();
+};
+
+Placement Executor::getPlacement(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	return (hibernated || resuming) ? placement : getThreadPlacement(thread.native_handle());
+}
 
-void Executor::run(ExecutorBody body, ExecutorAtStart atStart, ExecutorHook atStop) const {
+/* pinned before anything runs so that the memory the actor touches first is local to its CPUs. */
+void Executor::run(ExecutorAtStart atStart) {
+	pinCurrentThread(cpus);
 	const auto rc = atStart();
 	if (StatusCode::OK != rc)
-		return;
-	executeBody(body); //manage exception.
+		return terminate();
+	runBody();
+}
+
+void Executor::resume(void) {
+	pinCurrentThread(cpus);
+	hibernation.atWake();
+	runBody();
+}
+
+/* a hibernating executor is not terminated: its thread ends but the next message starts another one. */
+void Executor::runBody(void) {
+	if (!executeBody()) //manage exception.
+		return ;
 	atStop();
+	terminate();
+}
+
+void Executor::terminate(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	terminated = true;
+	terminatedCondition.notify_all();
+}
+
+bool Executor::waitTerminated(std::chrono::steady_clock::time_point deadline) {
+	std::unique_lock<std::mutex> l(mutex);
+	return terminatedCondition.wait_until(l, deadline, [this]() { return terminated; });
 }
 
-void Executor::executeBody(ExecutorBody body) const {
+/* returns false when the executor hibernates. */
+bool Executor::executeBody(void) {
 	while (true) {
+		if (0 != hibernation.idleTimeout && !waitMessage())
+			return false;
 		const auto message(messageQueue.get());
 		if (StatusCode::SHUTDOWN == body(message.type, message.code, message.params, message.sender))
-			return ;
+			return true;
+	}
+}
+
+/*
+ * with a wake up function, the link does not signal a consumer waiting in get(): the thread waits
+ * here until wakeUp() is called. After the idle timeout, it frees the mailbox batch and ends.
+ */
+bool Executor::waitMessage(void) {
+	const std::chrono::milliseconds timeout(hibernation.idleTimeout);
+	while (!messageQueue.hasMessage()) {
+		if (!messageQueue.trySleep())
+			continue;
+		std::unique_lock<std::mutex> l(mutex);
+		if (wakeUpCondition.wait_for(l, timeout, [this]() { return woken; })) {
+			woken = false;
+			continue;
+		}
+		l.unlock();
+		hibernation.atHibernate();
+		messageQueue.shrink();
+		l.lock();
+		if (woken) {
+			woken = false;
+			l.unlock();
+			hibernation.atWake();
+			continue;
+		}
+		placement = getThreadPlacement(thread.native_handle());
+		hibernated = true;
+		return false;
 	}
+	return true;
+}
+
+/*
+ * called once by the first message posted after the executor went to sleep. The poster does not pay
+ * for the thread of a hibernated executor: it is started from the timer thread.
+ */
+void Executor::wakeUp(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	if (!hibernated) {
+		woken = true;
+		wakeUpCondition.notify_one();
+		return ;
+	}
+	hibernated = false;
+	resuming = true;
+	l.unlock();
+	runAfter(0, [this]() { respawn(); });
+}
+
+/* the hibernated thread is ending: joining it only waits for it to return. */
+void Executor::respawn(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	thread.join();
+	thread = std::thread([this]() { resume(); });
+	resuming = false;
+	resumedCondition.notify_all();
 }
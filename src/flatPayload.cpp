@@ -0,0 +1,144 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <actor/flatPayload.h>
+#include <private/exception.h>
+
+#include <stdexcept>
+
+static const size_t HEADER_FIELD_SIZE = sizeof(uint32_t);
+static const size_t BYTES_ALIGNMENT = sizeof(uint32_t);
+static const size_t TABLE_ALIGNMENT = sizeof(uint64_t);
+
+static size_t headerSize(size_t nbFields) { return HEADER_FIELD_SIZE * (1 + nbFields); }
+
+FlatBuilder::FlatBuilder(unsigned int nbFields, size_t capacity) : nbFields(nbFields) {
+	data.reserve(std::max(capacity, headerSize(nbFields)));
+	data.resize(headerSize(nbFields));
+	FlatEncoding::store(static_cast<uint32_t>(nbFields), data.data());
+}
+
+FlatBuilder::~FlatBuilder() = default;
+
+FlatBuilder &FlatBuilder::set(unsigned int field, const std::string &value) {
+	setBytes(field, value.data(), value.size(), BYTES_ALIGNMENT);
+	return *this;
+}
+
+FlatBuilder &FlatBuilder::set(unsigned int field, const RawData &value) {
+	setBytes(field, value.data(), value.size(), BYTES_ALIGNMENT);
+	return *this;
+}
+
+FlatBuilder &FlatBuilder::set(unsigned int field, ByteSpan value) {
+	setBytes(field, value.data, value.size, BYTES_ALIGNMENT);
+	return *this;
+}
+
+FlatBuilder &FlatBuilder::setTable(unsigned int field, const RawData &table) {
+	setBytes(field, table.data(), table.size(), TABLE_ALIGNMENT);
+	return *this;
+}
+
+RawData FlatBuilder::finish(void) {
+	RawData table;
+	table.swap(data);
+	return table;
+}
+
+size_t FlatBuilder::allocate(unsigned int field, size_t size, size_t alignment) {
+	if (field >= nbFields)
+		THROW(std::out_of_range, "field is not in the table.");
+	const auto offset = (data.size() + alignment - 1) / alignment * alignment;
+	if (UINT32_MAX < offset + size)
+		THROW(std::length_error, "table is too large.");
+	data.resize(offset + size);
+	FlatEncoding::store(static_cast<uint32_t>(offset), data.data() + HEADER_FIELD_SIZE * (1 + field));
+	return offset;
+}
+
+void FlatBuilder::setBytes(unsigned int field, const void *bytes, size_t size, size_t alignment) {
+	const auto offset = allocate(field, alignment + size, alignment) + alignment;
+	FlatEncoding::store(static_cast<uint32_t>(size), data.data() + offset - sizeof(uint32_t));
+	if (0 < size)
+		std::memcpy(data.data() + offset, bytes, size);
+}
+
+FlatView::FlatView(const RawData &data) : FlatView(data.data(), data.size()) { }
+
+FlatView::FlatView(const uint8_t *bytes, size_t size) : bytes(bytes), size(size), nbFields(0) {
+	if (0 == size)
+		return ;
+	if (size < HEADER_FIELD_SIZE || size < headerSize(FlatEncoding::load<uint32_t>(bytes)))
+		THROW(std::runtime_error, "payload is shorter than the header of its table.");
+	nbFields = FlatEncoding::load<uint32_t>(bytes);
+}
+
+FlatView::~FlatView() = default;
+
+bool FlatView::has(unsigned int field) const {
+	return field < nbFields && 0 != FlatEncoding::load<uint32_t>(bytes + HEADER_FIELD_SIZE * (1 + field));
+}
+
+ByteSpan FlatView::getBytes(unsigned int field) const {
+	const auto offset = offsetOf(field, BYTES_ALIGNMENT);
+	if (0 == offset)
+		return ByteSpan { nullptr, 0 };
+	const size_t length = FlatEncoding::load<uint32_t>(bytes + offset);
+	checkInside(offset + BYTES_ALIGNMENT, length);
+	return ByteSpan { bytes + offset + BYTES_ALIGNMENT, length };
+}
+
+std::string FlatView::getString(unsigned int field) const {
+	const auto span = getBytes(field);
+	return std::string(static_cast<const char *>(span.data), span.size);
+}
+
+FlatView FlatView::getTable(unsigned int field) const {
+	const auto offset = offsetOf(field, TABLE_ALIGNMENT);
+	if (0 == offset)
+		return FlatView(nullptr, 0);
+	const size_t length = FlatEncoding::load<uint32_t>(bytes + offset + TABLE_ALIGNMENT - sizeof(uint32_t));
+	checkInside(offset + TABLE_ALIGNMENT, length);
+	return FlatView(bytes + offset + TABLE_ALIGNMENT, length);
+}
+
+size_t FlatView::offsetOf(unsigned int field, size_t valueSize) const {
+	if (!has(field))
+		return 0;
+	const size_t offset = FlatEncoding::load<uint32_t>(bytes + HEADER_FIELD_SIZE * (1 + field));
+	checkInside(offset, valueSize);
+	return offset;
+}
+
+void FlatView::checkInside(size_t offset, size_t valueSize) const {
+	if (offset > size || valueSize > size - offset)
+		THROW(std::runtime_error, "field is outside of the payload.");
+}
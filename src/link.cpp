@@ -28,20 +28,26 @@
  */
 
 #include <actor/link.h>
+#include <private/deferredTask.h>
 
-Link::Message::Message(MessageType type, int code, RawData params, SharedSenderLink sender) :
-				type(type), code(code), params(std::move(params)), sender(std::move(sender)), valid(true) { }
-Link::Message::Message() : type(MessageType::COMMAND_MESSAGE), code(0), valid(false) { }
+#include <algorithm>
+
+Link::Message::Message(MessageType type, int code, RawData params, SharedSenderLink sender, bool forced) :
+				type(type), code(code), params(std::move(params)), sender(std::move(sender)), forced(forced), valid(true) { }
+Link::Message::Message() : type(MessageType::COMMAND_MESSAGE), code(0), forced(false), valid(false) { }
 
 Link::Message::~Message() = default;
 Link::Message::Message(struct Message &&m) = default;
 
 bool Link::Message::isValid() { return valid; }
 
-Link::Link(std::string name) : SenderApi(std::move(name)) { }
+Link::Link(std::string name, MailBoxOptions options) : SenderApi(std::move(name)),
+								queue(options, []() { return Message(); }, [](const Message &m) { return !m.forced; }) { }
 Link::~Link() = default;
 
-SharedLink Link::create(std::string name) { return std::shared_ptr<Link>(new Link(std::move(name))); }
+SharedLink Link::create(std::string name, MailBoxOptions options) {
+	return std::shared_ptr<Link>(new Link(std::move(name), options));
+}
 
 void Link::post(Command command, SharedSenderLink sender) {
 	static const RawData EMPTY_DATA;
@@ -49,18 +55,76 @@ void Link::post(Command command, SharedSenderLink sender) {
 }
 
 void Link::post(Command command, const RawData &params, SharedSenderLink sender) {
-	putMessage(MessageType::COMMAND_MESSAGE, command, params, std::move(sender));
+	if (PostStatus::FULL == putMessage(MessageType::COMMAND_MESSAGE, command, params, std::move(sender), true))
+		throw MailBoxFull();
+}
+
+void Link::post(Command command, RawData &&params, SharedSenderLink sender) {
+	if (PostStatus::FULL == putMessage(MessageType::COMMAND_MESSAGE, command, std::move(params), std::move(sender), true))
+		throw MailBoxFull();
+}
+
+void Link::post(std::initializer_list<PostedCommand> commands, SharedSenderLink sender) {
+	putMessages(commands.begin(), commands.end(), sender);
+}
+
+void Link::post(const std::vector<PostedCommand> &commands, SharedSenderLink sender) {
+	putMessages(commands.begin(), commands.end(), sender);
+}
+
+PostStatus Link::tryPost(Command command, SharedSenderLink sender) {
+	static const RawData EMPTY_DATA;
+	return tryPost(command, EMPTY_DATA, std::move(sender));
+}
+
+PostStatus Link::tryPost(Command command, const RawData &params, SharedSenderLink sender) {
+	return putMessage(MessageType::COMMAND_MESSAGE, command, params, std::move(sender), false);
 }
 
 void Link::post(MessageType type, Command command, RawData params) {
 	static const SharedSenderLink NO_LINK;
-	putMessage(type, command, std::move(params), NO_LINK);
+	Message m(type, command, std::move(params), NO_LINK, true);
+	if (MessageType::COMMAND_MESSAGE == type)
+		queue.forcePost(std::move(m));
+	else
+		queue.postUrgent(std::move(m));
+}
+
+void Link::defer(ContinuationTask task) {
+	static const Command UNUSED_CODE = 0;
+	queue.forcePost(Message(MessageType::DEFERRED_MESSAGE, UNUSED_CODE, RawData(),
+							std::make_shared<DeferredTask>(std::move(task)), true));
+}
+
+void Link::forcePost(Message &&message) {
+	queue.forcePost(Message(message.type, message.code, std::move(message.params), std::move(message.sender), true));
 }
 
 struct Link::Message Link::get(void) { return queue.get(); }
 
 Link::Message Link::get(unsigned int timeout_in_ms) { return queue.get(timeout_in_ms); }
 
-void Link::putMessage(MessageType type, Command command, RawData params, SharedSenderLink sender) {
-	queue.post(Message(type, command, std::move(params), std::move(sender)));
+size_t Link::size(void) const { return queue.size(); }
+
+void Link::setWakeUp(std::function<void(void)> wakeUp) { queue.setWakeUp(std::move(wakeUp)); }
+
+bool Link::hasMessage(void) const { return queue.hasMessage(); }
+
+bool Link::trySleep(void) { return queue.trySleep(); }
+
+void Link::shrink(void) { queue.shrink(); }
+
+PostStatus Link::putMessage(MessageType type, Command command, RawData params, SharedSenderLink sender, bool canBlock) {
+	Message m(type, command, std::move(params), std::move(sender));
+	return canBlock ? queue.post(std::move(m)) : queue.tryPost(std::move(m));
+}
+
+template<typename Iterator>
+void Link::putMessages(Iterator first, Iterator last, const SharedSenderLink &sender) {
+	MailBox<Message>::Batch batch;
+	std::for_each(first, last, [&batch, &sender](const PostedCommand &c) {
+		batch.append(Message(MessageType::COMMAND_MESSAGE, c.first, c.second, sender));
+	});
+	if (PostStatus::FULL == queue.post(std::move(batch)))
+		throw MailBoxFull();
 }
@@ -0,0 +1,71 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <actor/payloadSerializer.h>
+#include <private/exception.h>
+
+#include <stdexcept>
+
+void PayloadReader::read(std::string &value) {
+	const auto size = readVarint();
+	const auto bytes = take(size);
+	value.assign(bytes, bytes + size);
+}
+
+void PayloadReader::read(RawData &value) {
+	const auto size = readVarint();
+	const auto bytes = take(size);
+	value = RawData(bytes, size);
+}
+
+void PayloadReader::read(std::vector<uint8_t> &value) {
+	const auto size = readVarint();
+	const auto bytes = take(size);
+	value.assign(bytes, bytes + size);
+}
+
+uint64_t PayloadReader::readVarint(void) {
+	uint64_t value = 0;
+	for (unsigned int shift = 0; shift < 64; shift += 7) {
+		const auto byte = *take(1);
+		value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+		if (0 == (byte & 0x80))
+			return value;
+	}
+	THROW(std::runtime_error, "varint of the payload is too long.");
+}
+
+const uint8_t *PayloadReader::take(size_t n) {
+	if (remaining() < n)
+		THROW(std::runtime_error, "payload is shorter than its fields.");
+	const auto bytes = data.data() + offset;
+	offset += n;
+	return bytes;
+}
@@ -0,0 +1,113 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <private/pooledExecutor.h>
+#include <private/schedulerImpl.h>
+
+PooledExecutor::PooledExecutor(Scheduler &scheduler, ExecutorBody body, Link &queue, ExecutorAtStart atStart,
+								ExecutorHook atStop, size_t messageBudget, bool asyncStart) :
+				scheduler(*scheduler.pImpl), body(body), atStart(atStart), atStop(atStop), messageQueue(queue),
+				messageBudget((0 == messageBudget) ? this->scheduler.getMessageBudget() : messageBudget),
+				nbTurns(0), nbBudgetExhausted(0), started(false), terminated(false) {
+	if (!asyncStart && !start())
+		return ;
+	messageQueue.setWakeUp([this]() { this->scheduler.schedule(*this); });
+	if (!started || !messageQueue.trySleep())
+		this->scheduler.schedule(*this);
+}
+
+PooledExecutor::~PooledExecutor() {
+	if (scheduler.isWorkerThread()) {
+		while (!isTerminated()) {
+			if (!scheduler.runPending())
+				std::this_thread::yield();
+		}
+		return ;
+	}
+	std::unique_lock<std::mutex> l(mutex);
+	terminatedCondition.wait(l, [this]() { return terminated; });
+}
+
+/* a worker thread runs the other actors while it waits, as the destructor does. */
+bool PooledExecutor::waitTerminated(std::chrono::steady_clock::time_point deadline) {
+	if (scheduler.isWorkerThread()) {
+		while (!isTerminated() && std::chrono::steady_clock::now() < deadline) {
+			if (!scheduler.runPending())
+				std::this_thread::yield();
+		}
+		return isTerminated();
+	}
+	std::unique_lock<std::mutex> l(mutex);
+	return terminatedCondition.wait_until(l, deadline, [this]() { return terminated; });
+}
+
+Placement PooledExecutor::getPlacement(void) { return scheduler.getPlacement(); }
+
+SchedulingStatistics PooledExecutor::getStatistics(void) const { return SchedulingStatistics(nbTurns, nbBudgetExhausted); }
+
+void PooledExecutor::run(void) {
+	nbTurns.fetch_add(1, std::memory_order_relaxed);
+	if (!started && !start())
+		return ;
+	size_t nbProcessed = 0;
+	do {
+		for (; messageQueue.hasMessage(); nbProcessed++) {
+			if (messageBudget == nbProcessed) {
+				nbBudgetExhausted.fetch_add(1, std::memory_order_relaxed);
+				return scheduler.yield(*this);
+			}
+			const auto message(messageQueue.get());
+			if (StatusCode::SHUTDOWN == body(message.type, message.code, message.params, message.sender))
+				return terminate();
+		}
+	} while (!messageQueue.trySleep());
+}
+
+/* a failed start terminates the executor without calling atStop. */
+bool PooledExecutor::start(void) {
+	started = true;
+	if (StatusCode::OK == atStart())
+		return true;
+	std::unique_lock<std::mutex> l(mutex);
+	terminated = true;
+	terminatedCondition.notify_all();
+	return false;
+}
+
+void PooledExecutor::terminate(void) {
+	atStop();
+	std::unique_lock<std::mutex> l(mutex);
+	terminated = true;
+	terminatedCondition.notify_all();
+}
+
+bool PooledExecutor::isTerminated(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	return terminated;
+}
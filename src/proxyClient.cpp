@@ -30,10 +30,49 @@
 #include <private/types.h>
 #include <private/clientSocket.h>
 #include <private/proxyClient.h>
+#include <private/exception.h>
+
+#include <mutex>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+/* shared with the reply reader, which may outlive the proxy until its next read returns. */
+struct ProxyClient::Channel {
+	const Connection connection;
+	std::mutex writing;
+	std::mutex mutex;
+	std::map<Id, std::weak_ptr<SenderApi>> pendingRequests;
+	/* size of pendingRequests that triggers the removal of the requests whose reply sender is gone. */
+	size_t nextSweep;
+	Id nextRequestId;
+	bool readingReplies;
+	std::atomic<bool> closed;
+
+	explicit Channel(Connection connection) : connection(std::move(connection)), nextSweep(MIN_SWEEP), nextRequestId(0),
+											readingReplies(false), closed(false) { }
+
+	/* the replies of the asks already expired or destroyed are not waited for anymore. */
+	void sweepPendingRequests(void) {
+		if (pendingRequests.size() < nextSweep)
+			return ;
+		for (auto it = pendingRequests.begin(); pendingRequests.end() != it; ) {
+			if (it->second.expired())
+				it = pendingRequests.erase(it);
+			else
+				++it;
+		}
+		nextSweep = std::max(MIN_SWEEP, 2 * pendingRequests.size());
+	}
+private:
+	static const size_t MIN_SWEEP = 64;
+};
 
 ProxyClient::ProxyClient(std::string name, Connection connection) :
-						SenderApi(std::move(name)), connection(std::move(connection)) { }
-ProxyClient::~ProxyClient() = default;
+						SenderApi(std::move(name)), channel(std::make_shared<Channel>(std::move(connection))) { }
+
+ProxyClient::~ProxyClient() { channel->closed = true; }
 
 void ProxyClient::post(Command command, SharedSenderLink sender) {
 	static const RawData EMPTY_DATA;
@@ -42,5 +81,53 @@ void ProxyClient::post(Command command, SharedSenderLink sender) {
 
 void ProxyClient::post(Command command, const RawData &params, SharedSenderLink sender) {
 	const auto senderName = (nullptr == sender.get()) ?  std::string() : sender->getName();
-	connection.writeInt(postType::NewMessage).writeString(senderName).writeInt(command).writeRawData(params);
+	const auto bytes = params.serialized();
+	std::unique_lock<std::mutex> l(channel->writing);
+	channel->connection.writeInt(postType::NewMessage).writeString(senderName).writeInt(command).writeRawData(bytes);
+}
+
+/* a request never answered keeps its entry until its reply sender is destroyed. */
+void ProxyClient::request(Command command, const RawData &params, SharedSenderLink replyTo) {
+	const auto bytes = params.serialized();
+	Id id;
+	{
+		std::unique_lock<std::mutex> l(channel->mutex);
+		id = channel->nextRequestId++;
+		channel->sweepPendingRequests();
+		channel->pendingRequests[id] = replyTo;
+		if (!channel->readingReplies) {
+			channel->readingReplies = true;
+			std::thread(readReplies, channel).detach();
+		}
+	}
+	std::unique_lock<std::mutex> l(channel->writing);
+	channel->connection.writeInt(postType::NewRequest).writeInt(id).writeInt(command).writeRawData(bytes);
+}
+
+size_t ProxyClient::getNbPendingRequests(void) const {
+	std::unique_lock<std::mutex> l(channel->mutex);
+	return channel->pendingRequests.size();
+}
+
+void ProxyClient::readReplies(std::shared_ptr<Channel> channel) {
+	const auto &connection = channel->connection;
+	while (!channel->closed) {
+		try {
+			if (postType::Reply != connection.readInt<postType>())
+				continue;
+			const auto id = connection.readInt<Id>();
+			const auto command = connection.readInt<Command>();
+			const auto data = connection.readRawData();
+			std::unique_lock<std::mutex> l(channel->mutex);
+			const auto it = channel->pendingRequests.find(id);
+			if (channel->pendingRequests.end() == it)
+				continue;
+			const auto replyTo = it->second.lock();
+			channel->pendingRequests.erase(it);
+			l.unlock();
+			if (nullptr != replyTo)
+				replyTo->post(command, data);
+		} catch (const ConnectionTimeout &) { continue ; }
+		  catch (const std::runtime_error &) { return ; }
+	}
 }
@@ -31,8 +31,56 @@
 #include <private/serverSocket.h>
 #include <private/proxyContainer.h>
 #include <private/internalCommands.h>
+#include <actor/commandMap.h>
 
 #include <arpa/inet.h>
+#include <mutex>
+#include <atomic>
+
+/* replies are written by the actors while the server thread reads the next messages. */
+struct ReplyChannel {
+	const Connection connection;
+	std::mutex writing;
+	explicit ReplyChannel(Connection connection) : connection(std::move(connection)) { }
+};
+
+/* sender of a remote request: its first message goes back to the requester with the correlation id. */
+class RemoteReply : public SenderApi {
+public:
+	RemoteReply(std::shared_ptr<ReplyChannel> channel, Id id) : SenderApi(std::string()), channel(std::move(channel)),
+																	id(id), replied(false) { }
+	~RemoteReply() = default;
+
+	void post(Command command, SharedSenderLink sender = SharedSenderLink()) override {
+		static const RawData EMPTY_DATA;
+		post(command, EMPTY_DATA, std::move(sender));
+	}
+
+	/*
+	 * the requester times out when the connection is lost. A reply that cannot be serialized is
+	 * answered with REPLY_NOT_SERIALIZABLE instead.
+	 */
+	void post(Command command, const RawData &data, SharedSenderLink = SharedSenderLink()) override {
+		if (replied)
+			return ;
+		RawData bytes;
+		try {
+			bytes = data.serialized();
+		} catch (const std::exception &) {
+			command = REPLY_NOT_SERIALIZABLE;
+		}
+		if (replied.exchange(true))
+			return ;
+		try {
+			std::unique_lock<std::mutex> l(channel->writing);
+			channel->connection.writeInt(postType::Reply).writeInt(id).writeInt(command).writeRawData(bytes);
+		} catch (const std::runtime_error &) { }
+	}
+private:
+	const std::shared_ptr<ReplyChannel> channel;
+	const Id id;
+	std::atomic<bool> replied;
+};
 
 ProxyServer::ProxyServer(SharedSenderLink actor, Connection connection, std::function<void(void)> notifyTerminate,
 						FindActor findActor) :
@@ -46,16 +94,27 @@ ProxyServer::~ProxyServer() {
 
 void ProxyServer::serverBody(SharedSenderLink actor, Connection connection, std::function<void(void)> notifyTerminate,
 								FindActor findActor) {
+	const auto channel = std::make_shared<ReplyChannel>(std::move(connection));
+	const auto &c = channel->connection;
 	while (true) {
+		postType type;
 		try {
-			if (postType::NewMessage != connection.readInt<postType>())
+			type = c.readInt<postType>();
+			if (postType::NewMessage != type && postType::NewRequest != type)
 				continue;
 		} catch (const ConnectionTimeout &) { continue ; }
 		  catch (const std::runtime_error &) {  return; }
-		const auto name = connection.readString();
-		const auto sender = (name.size() > 0) ? findActor(name) : SharedSenderLink();
-		const auto command = connection.readInt<uint32_t>();
-		actor->post(command, connection.readRawData(), std::move(sender));
+		SharedSenderLink sender;
+		if (postType::NewRequest == type)
+			sender = std::make_shared<RemoteReply>(channel, c.readInt<Id>());
+		else {
+			const auto name = c.readString();
+			sender = (name.size() > 0) ? findActor(name) : SharedSenderLink();
+		}
+		const auto command = c.readInt<uint32_t>();
+		/* a peer must not block nor kill the server: messages that find the mailbox full are dropped. */
+		if (PostStatus::FULL == actor->tryPost(command, c.readRawData(), sender) && postType::NewRequest == type)
+			sender->post(MAILBOX_FULL);
 		if (InternalCommands::SHUTDOWN == command) {
 			notifyTerminate();
 			return;
@@ -28,24 +28,141 @@
  */
 
 #include <actor/rawData.h>
+#include <actor/typedPayload.h>
 #include <private/exception.h>
 
 #include <algorithm>
+#include <atomic>
+#include <stdexcept>
 #include <arpa/inet.h>
 
-RawData::RawData() = default;
+RawData::RawData() : length(0) { }
 
-RawData::RawData(uint32_t value) {
-	uint32_t independantOrderValue = htonl(value);
-	*this = RawData(&independantOrderValue, sizeof(independantOrderValue));
+RawData::RawData(uint32_t value) : RawData() {
+	const uint32_t independantOrderValue = htonl(value);
+	append(&independantOrderValue, sizeof(independantOrderValue));
 }
 
-RawData::RawData(void *buffer, size_t size) : v(reinterpret_cast<uint8_t *>(buffer), reinterpret_cast<uint8_t *>(buffer) + size) { }
+RawData::RawData(size_t size, uint8_t value) : RawData() { resize(size, value); }
 
-RawData::RawData(const std::string &s) : v(s.begin(), s.end()) { }
+RawData::RawData(const void *buffer, size_t size) : RawData() { append(buffer, size); }
+
+RawData::RawData(const std::string &s) : RawData(s.data(), s.size()) { }
+
+RawData::RawData(std::initializer_list<uint8_t> bytes) : RawData(bytes.begin(), bytes.size()) { }
+
+RawData::RawData(std::vector<uint8_t> &&bytes) : RawData() {
+	if (INLINE_CAPACITY < bytes.size())
+		this->bytes = std::make_shared<std::vector<uint8_t>>(std::move(bytes));
+	else
+		append(bytes.data(), bytes.size());
+}
+
+RawData::RawData(std::shared_ptr<const TypedObject> object) : RawData() { this->object = std::move(object); }
 
 RawData::~RawData() = default;
 
+const uint8_t &RawData::at(size_t i) const {
+	if (i >= size())
+		THROW(std::out_of_range, "raw data index out of range.");
+	return (*this)[i];
+}
+
+uint8_t &RawData::at(size_t i) {
+	if (i >= size())
+		THROW(std::out_of_range, "raw data index out of range.");
+	return (*this)[i];
+}
+
+void RawData::push_back(uint8_t byte) {
+	if (nullptr != bytes)
+		return own().push_back(byte);
+	if (INLINE_CAPACITY == length)
+		return (spill(2 * INLINE_CAPACITY), own().push_back(byte));
+	inlineBytes[length++] = byte;
+}
+
+void RawData::append(const void *buffer, size_t size) {
+	const auto first = static_cast<const uint8_t *>(buffer);
+	append(first, first + size);
+}
+
+RawData::iterator RawData::insert(const_iterator position, size_t count, uint8_t value) {
+	const auto room = open(position - cbegin(), count);
+	std::fill(room, room + count, value);
+	return room;
+}
+
+RawData::iterator RawData::erase(const_iterator first, const_iterator last) {
+	const auto offset = first - cbegin();
+	const auto count = last - first;
+	const auto oldSize = size();
+	std::move(data() + offset + count, data() + oldSize, data() + offset);
+	resize(oldSize - count);
+	return data() + offset;
+}
+
+void RawData::resize(size_t size, uint8_t value) {
+	if (nullptr != bytes)
+		return own().resize(size, value);
+	if (INLINE_CAPACITY < size)
+		return (spill(size), own().resize(size, value));
+	if (length < size)
+		std::fill(inlineBytes + length, inlineBytes + size, value);
+	length = size;
+}
+
+void RawData::reserve(size_t capacity) {
+	if (nullptr != bytes)
+		own().reserve(capacity);
+	else if (INLINE_CAPACITY < capacity)
+		spill(capacity);
+}
+
+void RawData::shrink_to_fit(void) {
+	if (nullptr == bytes || 1 < bytes.use_count())
+		return ;
+	auto &owned = own();
+	if (INLINE_CAPACITY < owned.size())
+		return owned.shrink_to_fit();
+	length = owned.size();
+	std::copy(owned.begin(), owned.end(), inlineBytes);
+	bytes.reset();
+}
+
+bool RawData::operator==(const RawData &d) const {
+	return object == d.object && size() == d.size() && (shares(d) || std::equal(begin(), end(), d.begin()));
+}
+
+/*
+ * use_count() is a relaxed load: once it says the buffer is ours, the fence orders the reads the other
+ * owners made before releasing it before the writes done here.
+ */
+std::vector<uint8_t> &RawData::own(void) {
+	if (1 < bytes.use_count())
+		bytes = std::make_shared<std::vector<uint8_t>>(*bytes);
+	else
+		std::atomic_thread_fence(std::memory_order_acquire);
+	return *bytes;
+}
+
+void RawData::spill(size_t capacity) {
+	auto spilled = std::make_shared<std::vector<uint8_t>>();
+	spilled->reserve(capacity);
+	spilled->assign(inlineBytes, inlineBytes + length);
+	bytes = std::move(spilled);
+	length = 0;
+}
+
+RawData::iterator RawData::open(size_t offset, size_t count) {
+	const auto oldSize = size();
+	resize(oldSize + count);
+	std::move_backward(data() + offset, data() + oldSize, data() + oldSize + count);
+	return data() + offset;
+}
+
+RawData RawData::serialized(void) const { return (nullptr == object) ? *this : object->encode(); }
+
 std::string RawData::toString() const { return std::string(begin(), end()); }
 uint32_t RawData::toInt() const {
 	uint32_t rc;
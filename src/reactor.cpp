@@ -0,0 +1,165 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <private/reactor.h>
+#include <private/exception.h>
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+
+IoReadiness::IoReadiness(const RawData &params) : fd(-1), events(0) {
+	if (sizeof(fd) + sizeof(events) != params.size())
+		THROW(std::runtime_error, "not an io readiness.");
+	memcpy(&fd, params.data(), sizeof(fd));
+	memcpy(&events, params.data() + sizeof(fd), sizeof(events));
+}
+
+RawData IoReadiness::toRawData(void) const {
+	RawData params(sizeof(fd) + sizeof(events));
+	memcpy(params.data(), &fd, sizeof(fd));
+	memcpy(params.data() + sizeof(fd), &events, sizeof(events));
+	return params;
+}
+
+static uint32_t toEpollEvents(uint32_t events) {
+	return EPOLLONESHOT | ((IO_READABLE & events) ? (EPOLLIN | EPOLLRDHUP) : 0) |
+			((IO_WRITABLE & events) ? static_cast<uint32_t>(EPOLLOUT) : 0);
+}
+
+/* errors and hang ups are reported as the events watched: the next read or write returns them. */
+static uint32_t fromEpollEvents(uint32_t ready, uint32_t watched) {
+	if ((EPOLLERR | EPOLLHUP) & ready)
+		return watched;
+	return watched & ((((EPOLLIN | EPOLLRDHUP) & ready) ? static_cast<uint32_t>(IO_READABLE) : 0) |
+						((EPOLLOUT & ready) ? static_cast<uint32_t>(IO_WRITABLE) : 0));
+}
+
+static uint64_t toEpollData(int fd, uint32_t generation) {
+	return (static_cast<uint64_t>(generation) << 32) | static_cast<uint32_t>(fd);
+}
+
+Reactor::Reactor() : epollFd(epoll_create1(EPOLL_CLOEXEC)), stopFd(eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)),
+					nextGeneration(0) {
+	if (-1 == epollFd || -1 == stopFd)
+		THROW(std::runtime_error, "cannot create the reactor.");
+	struct epoll_event event;
+	event.events = EPOLLIN;
+	event.data.u64 = toEpollData(stopFd, 0);
+	if (-1 == epoll_ctl(epollFd, EPOLL_CTL_ADD, stopFd, &event))
+		THROW(std::runtime_error, "cannot create the reactor.");
+	thread = std::thread([this]() { run(); });
+}
+
+Reactor::~Reactor() {
+	const uint64_t one = 1;
+	if (sizeof(one) != write(stopFd, &one, sizeof(one)))
+		std::terminate();
+	thread.join();
+	close(stopFd);
+	close(epollFd);
+}
+
+Reactor &Reactor::get(void) {
+	static Reactor reactor;
+	return reactor;
+}
+
+void Reactor::watch(int fd, uint32_t events, Command command, const SharedLink &link) {
+	std::unique_lock<std::mutex> l(mutex);
+	const auto generation = ++nextGeneration;
+	struct epoll_event event;
+	event.events = toEpollEvents(events);
+	event.data.u64 = toEpollData(fd, generation);
+	if (-1 == epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event) &&
+			(ENOENT != errno || -1 == epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event)))
+		THROW(std::runtime_error, "cannot watch the descriptor.");
+	watches[fd] = Watch { events, command, link, generation };
+}
+
+/* a closed descriptor is already removed from the epoll set. */
+void Reactor::unwatch(int fd) {
+	std::unique_lock<std::mutex> l(mutex);
+	if (0 == watches.erase(fd))
+		return ;
+	epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void Reactor::run(void) {
+	static const int MAX_EVENTS = 64;
+	struct epoll_event events[MAX_EVENTS];
+	while (true) {
+		const auto nbEvents = epoll_wait(epollFd, events, MAX_EVENTS, -1);
+		if (-1 == nbEvents && EINTR != errno)
+			THROW(std::runtime_error, "error while waiting for descriptors.");
+		for (int i = 0; i < nbEvents; i++) {
+			if (toEpollData(stopFd, 0) == events[i].data.u64)
+				return ;
+			dispatch(events[i].data.u64, events[i].events);
+		}
+	}
+}
+
+/*
+ * a readiness for a replaced or removed watch is dropped. The others are forced in the mailbox: the
+ * reactor never waits for room nor fails, and one shot watches bound them to one per descriptor.
+ */
+void Reactor::dispatch(uint64_t data, uint32_t ready) {
+	const auto fd = static_cast<int>(data & 0xFFFFFFFF);
+	const auto generation = static_cast<uint32_t>(data >> 32);
+	std::unique_lock<std::mutex> l(mutex);
+	const auto w = watches.find(fd);
+	if (watches.end() == w || generation != w->second.generation)
+		return ;
+	const auto link = w->second.link.lock();
+	if (nullptr == link) {
+		watches.erase(w);
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, nullptr);
+		return ;
+	}
+	const auto command = w->second.command;
+	const IoReadiness readiness(fd, fromEpollEvents(ready, w->second.events));
+	l.unlock();
+	link->post(MessageType::COMMAND_MESSAGE, command, readiness.toRawData());
+	link->defer([this, fd, generation]() { rearm(fd, generation); return StatusCode::OK; });
+}
+
+void Reactor::rearm(int fd, uint32_t generation) {
+	std::unique_lock<std::mutex> l(mutex);
+	const auto w = watches.find(fd);
+	if (watches.end() == w || generation != w->second.generation)
+		return ;
+	struct epoll_event event;
+	event.events = toEpollEvents(w->second.events);
+	event.data.u64 = toEpollData(fd, generation);
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, fd, &event);
+}
@@ -0,0 +1,122 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <actor/reply.h>
+#include <private/replySlot.h>
+#include <actor/timer.h>
+
+#include <algorithm>
+
+ReplySlot::ReplySlot() : SenderApi(std::string()), replied(false), command(0) { }
+
+ReplySlot::~ReplySlot() = default;
+
+void ReplySlot::post(Command command, SharedSenderLink sender) {
+	static const RawData EMPTY_DATA;
+	post(command, EMPTY_DATA, std::move(sender));
+}
+
+void ReplySlot::post(Command command, const RawData &data, SharedSenderLink) {
+	std::unique_lock<std::mutex> l(mutex);
+	if (replied)
+		return ;
+	this->command = command;
+	this->data = data;
+	replied = true;
+	repliedCondition.notify_all();
+	l.unlock();
+	expire();
+}
+
+bool ReplySlot::onReply(std::function<void(void)> callback) {
+	std::unique_lock<std::mutex> l(mutex);
+	if (replied)
+		return false;
+	this->callback = std::move(callback);
+	return true;
+}
+
+/* the callback is called by the first of the reply and the timer. */
+void ReplySlot::expire(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	const auto c = std::move(callback);
+	callback = nullptr;
+	l.unlock();
+	if (c)
+		c();
+}
+
+bool ReplySlot::wait(std::chrono::steady_clock::time_point deadline) {
+	std::unique_lock<std::mutex> l(mutex);
+	return repliedCondition.wait_until(l, deadline, [this]() { return replied; });
+}
+
+bool ReplySlot::isReady(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	return replied;
+}
+
+Command ReplySlot::getCommand(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	return command;
+}
+
+RawData ReplySlot::getData(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	return data;
+}
+
+Reply::Reply(std::shared_ptr<ReplySlot> slot, unsigned int timeout_in_ms) : slot(std::move(slot)),
+			deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_in_ms)) { }
+
+Reply::~Reply() = default;
+
+bool Reply::wait(void) const { return slot->wait(deadline); }
+
+bool Reply::isReady(void) const { return slot->isReady(); }
+
+Command Reply::getCommand(void) const {
+	if (!wait())
+		throw ReplyTimeout();
+	return slot->getCommand();
+}
+
+RawData Reply::get(void) const {
+	if (!wait())
+		throw ReplyTimeout();
+	return slot->getData();
+}
+
+void Reply::then(std::function<void(void)> callback) const {
+	if (!slot->onReply(callback))
+		return callback();
+	const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+	const auto s = slot;
+	runAfter(std::max<long long>(0, remaining.count() + 1), [s]() { s->expire(); });
+}
@@ -0,0 +1,158 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+
+#include <actor/router.h>
+#include <actor/link.h>
+#include <private/exception.h>
+
+#include <atomic>
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+/* an object has no bytes: its encoding is the key. */
+const RoutingKey PAYLOAD_ROUTING_KEY = [](Command, const RawData &params) { return params.serialized().toString(); };
+
+static const unsigned int VIRTUAL_NODES_PER_ROUTEE = 64;
+
+class Router::RouterLink : public SenderApi {
+public:
+	RouterLink(std::string name, const std::vector<std::unique_ptr<Actor>> &routees, RoutingPolicy policy,
+				RoutingKey key) :
+				SenderApi(std::move(name)), policy(policy), key(std::move(key)), next(0) {
+		for (const auto &r : routees)
+			/* the link of an actor is its mailbox. */
+			links.push_back(std::static_pointer_cast<Link>(r->getActorLinkRef()));
+		if (RoutingPolicy::CONSISTENT_HASH == policy)
+			buildRing();
+	}
+	~RouterLink() = default;
+
+	void post(Command command, SharedSenderLink sender) override {
+		static const RawData EMPTY_DATA;
+		route(command, EMPTY_DATA)->post(command, std::move(sender));
+	}
+
+	void post(Command command, const RawData &params, SharedSenderLink sender) override {
+		route(command, params)->post(command, params, std::move(sender));
+	}
+
+	PostStatus tryPost(Command command, const RawData &params, SharedSenderLink sender) override {
+		return route(command, params)->tryPost(command, params, std::move(sender));
+	}
+
+	void request(Command command, const RawData &params, SharedSenderLink replyTo) override {
+		route(command, params)->request(command, params, std::move(replyTo));
+	}
+
+private:
+	const RoutingPolicy policy;
+	const RoutingKey key;
+	std::vector<SharedLink> links;
+	std::vector<std::pair<size_t, size_t>> ring;
+	std::atomic<size_t> next;
+
+	const SharedLink &route(Command command, const RawData &params) {
+		switch (policy) {
+			case RoutingPolicy::LEAST_QUEUE_DEPTH:
+				return leastLoaded();
+			case RoutingPolicy::CONSISTENT_HASH:
+				return onRing(std::hash<std::string>()(key(command, params)));
+			default:
+				return links[next.fetch_add(1, std::memory_order_relaxed) % links.size()];
+		}
+	}
+
+	/* starts the scan at a different routee each time so that idle routees share the load. */
+	const SharedLink &leastLoaded(void) {
+		const auto start = next.fetch_add(1, std::memory_order_relaxed);
+		auto chosen = start % links.size();
+		auto depth = std::numeric_limits<size_t>::max();
+		for (size_t i = 0; i < links.size() && 0 < depth; i++) {
+			const auto candidate = (start + i) % links.size();
+			const auto candidateDepth = links[candidate]->size();
+			if (candidateDepth < depth) {
+				chosen = candidate;
+				depth = candidateDepth;
+			}
+		}
+		return links[chosen];
+	}
+
+	const SharedLink &onRing(size_t hash) const {
+		auto point = std::upper_bound(ring.begin(), ring.end(), std::make_pair(hash, std::numeric_limits<size_t>::max()));
+		return links[((ring.end() == point) ? ring.front() : *point).second];
+	}
+
+	/* each routee owns several points of the ring so that the keys are spread evenly. */
+	void buildRing(void) {
+		for (size_t i = 0; i < links.size(); i++) {
+			for (unsigned int v = 0; v < VIRTUAL_NODES_PER_ROUTEE; v++)
+				ring.emplace_back(std::hash<std::string>()(links[i]->getName() + "#" + std::to_string(v)), i);
+		}
+		std::sort(ring.begin(), ring.end());
+	}
+};
+
+static std::vector<std::unique_ptr<Actor>> spawnRoutees(const std::string &name, size_t nbRoutees,
+														CommandExecutorFactory factory, ActorOptions options) {
+	if (0 == nbRoutees)
+		THROW(std::runtime_error, "a router needs at least one routee.");
+	return Actor::spawnAll(nbRoutees, [&name, &factory](size_t index, const ActorOptions &options) {
+		return std::make_unique<Actor>(name + "/" + std::to_string(index), factory(index), options);
+	}, std::move(options));
+}
+
+Router::Router(std::string name, size_t nbRoutees, CommandExecutorFactory factory, RoutingPolicy policy,
+				ActorOptions options, RoutingKey key) :
+				routees(spawnRoutees(name, nbRoutees, std::move(factory), std::move(options))),
+				link(std::make_shared<RouterLink>(std::move(name), routees, policy, std::move(key))) { }
+
+Router::~Router() = default;
+
+void Router::post(Command command, SharedSenderLink sender) const { link->post(command, std::move(sender)); }
+
+void Router::post(Command command, const RawData &params, SharedSenderLink sender) const {
+	link->post(command, params, std::move(sender));
+}
+
+Reply Router::ask(Command command, unsigned int timeout_in_ms) const { return link->ask(command, timeout_in_ms); }
+
+Reply Router::ask(Command command, const RawData &params, unsigned int timeout_in_ms) const {
+	return link->ask(command, params, timeout_in_ms);
+}
+
+const std::string &Router::getName(void) const { return link->getName(); }
+
+SharedSenderLink Router::getActorLinkRef() const { return link; }
+
+size_t Router::getNbRoutees(void) const { return routees.size(); }
+
+Actor &Router::getRoutee(size_t index) const { return *routees.at(index); }
@@ -0,0 +1,209 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <actor/scheduler.h>
+#include <private/schedulerImpl.h>
+#include <private/cpuAffinity.h>
+
+#include <algorithm>
+
+static thread_local const void *currentScheduler = nullptr;
+thread_local Scheduler::SchedulerImpl::Worker *Scheduler::SchedulerImpl::currentWorker = nullptr;
+
+Scheduler::SchedulerImpl::SchedulerImpl(unsigned int nbWorkers, const CpuSet &cpus, size_t messageBudget) :
+						nbInjected(0), nbSleeping(0), stopping(false), messageBudget((0 == messageBudget) ? 1 : messageBudget) {
+	checkCpuSet(cpus);
+	const auto n = (Scheduler::HARDWARE_CONCURRENCY == nbWorkers) ?
+								std::max(1u, std::thread::hardware_concurrency()) : nbWorkers;
+	auto cpu = cpus.begin();
+	for (unsigned int i = 0; i < n; i++) {
+		workers.emplace_back(new Worker(i, cpus.empty() ? CpuSet() : CpuSet { *cpu }));
+		if (!cpus.empty() && cpus.end() == ++cpu)
+			cpu = cpus.begin();
+	}
+	for (auto &w : workers) {
+		auto &worker = *w;
+		worker.thread = std::thread([this, &worker]() { work(worker); });
+	}
+}
+
+Scheduler::SchedulerImpl::~SchedulerImpl() {
+	{
+		std::unique_lock<std::mutex> l(mutex);
+		stopping = true;
+		condition.notify_all();
+	}
+	for (auto &w : workers)
+		w->thread.join();
+}
+
+void Scheduler::SchedulerImpl::schedule(Runnable &runnable) {
+	if (isWorkerThread()) {
+		currentWorker->runQueue.push(&runnable);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (0 < nbSleeping)
+			wakeUpSleeping();
+		return ;
+	}
+	inject(runnable);
+}
+
+void Scheduler::SchedulerImpl::yield(Runnable &runnable) {
+	if (isWorkerThread())
+		currentWorker->nbBudgetExhausted.fetch_add(1, std::memory_order_relaxed);
+	inject(runnable);
+}
+
+void Scheduler::SchedulerImpl::inject(Runnable &runnable) {
+	std::unique_lock<std::mutex> l(mutex);
+	injectionQueue.push_back(&runnable);
+	nbInjected++;
+	condition.notify_one();
+}
+
+bool Scheduler::SchedulerImpl::runPending(void) {
+	auto runnable = next(*currentWorker);
+	if (nullptr == runnable)
+		return false;
+	run(*currentWorker, *runnable);
+	return true;
+}
+
+bool Scheduler::SchedulerImpl::isWorkerThread(void) const { return this == currentScheduler; }
+
+unsigned int Scheduler::SchedulerImpl::getNbWorkers(void) const { return workers.size(); }
+
+Placement Scheduler::SchedulerImpl::getPlacement(void) const {
+	Placement placement;
+	for (const auto &w : workers) {
+		const auto p = getThreadPlacement(w->thread.native_handle());
+		placement.cpus.insert(p.cpus.begin(), p.cpus.end());
+		placement.numaNodes.insert(p.numaNodes.begin(), p.numaNodes.end());
+	}
+	return placement;
+}
+
+size_t Scheduler::SchedulerImpl::getMessageBudget(void) const { return messageBudget; }
+
+SchedulingStatistics Scheduler::SchedulerImpl::getStatistics(void) const {
+	SchedulingStatistics statistics;
+	for (const auto &w : workers) {
+		statistics.nbTurns += w->nbTurns.load(std::memory_order_relaxed);
+		statistics.nbBudgetExhausted += w->nbBudgetExhausted.load(std::memory_order_relaxed);
+	}
+	return statistics;
+}
+
+void Scheduler::SchedulerImpl::work(Worker &self) {
+	pinCurrentThread(self.cpus);
+	currentScheduler = this;
+	currentWorker = &self;
+	do {
+		for (auto runnable = next(self); nullptr != runnable; runnable = next(self))
+			run(self, *runnable);
+	} while (park());
+}
+
+void Scheduler::SchedulerImpl::run(Worker &self, Runnable &runnable) {
+	self.nbTurns.fetch_add(1, std::memory_order_relaxed);
+	runnable.run();
+}
+
+Runnable *Scheduler::SchedulerImpl::next(Worker &self) {
+	Runnable *runnable;
+	if (0 == ++self.nbPicks % INJECTION_POLL_INTERVAL && nullptr != (runnable = takeInjected()))
+		return runnable;
+	if (self.runQueue.pop(runnable))
+		return runnable;
+	runnable = takeInjected();
+	return (nullptr != runnable) ? runnable : steal(self);
+}
+
+Runnable *Scheduler::SchedulerImpl::takeInjected(void) {
+	if (0 == nbInjected)
+		return nullptr;
+	std::unique_lock<std::mutex> l(mutex);
+	if (injectionQueue.empty())
+		return nullptr;
+	const auto runnable = injectionQueue.front();
+	injectionQueue.pop_front();
+	nbInjected--;
+	return runnable;
+}
+
+Runnable *Scheduler::SchedulerImpl::steal(const Worker &self) {
+	Runnable *runnable;
+	for (size_t i = 1; i < workers.size(); i++) {
+		if (workers[(self.index + i) % workers.size()]->runQueue.steal(runnable))
+			return runnable;
+	}
+	return nullptr;
+}
+
+/* returns false when the worker must exit. */
+bool Scheduler::SchedulerImpl::park(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	nbSleeping++;
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	condition.wait(l, [this]() { return stopping || hasWork(); });
+	nbSleeping--;
+	return hasWork();
+}
+
+bool Scheduler::SchedulerImpl::hasWork(void) const {
+	if (!injectionQueue.empty())
+		return true;
+	for (const auto &w : workers) {
+		if (!w->runQueue.empty())
+			return true;
+	}
+	return false;
+}
+
+void Scheduler::SchedulerImpl::wakeUpSleeping(void) {
+	std::unique_lock<std::mutex> l(mutex);
+	condition.notify_one();
+}
+
+Scheduler::Scheduler(unsigned int nbWorkers, CpuSet cpus, size_t messageBudget) :
+												pImpl(new SchedulerImpl(nbWorkers, cpus, messageBudget)) { }
+
+Scheduler::~Scheduler() { delete pImpl; }
+
+unsigned int Scheduler::getNbWorkers(void) const { return pImpl->getNbWorkers(); }
+
+Placement Scheduler::getPlacement(void) const { return pImpl->getPlacement(); }
+
+size_t Scheduler::getMessageBudget(void) const { return pImpl->getMessageBudget(); }
+
+SchedulingStatistics Scheduler::getStatistics(void) const { return pImpl->getStatistics(); }
+
+SharedScheduler Scheduler::create(unsigned int nbWorkers, CpuSet cpus, size_t messageBudget) {
+	return std::make_shared<Scheduler>(nbWorkers, std::move(cpus), messageBudget);
+}
@@ -28,11 +28,41 @@
  */
 
 #include <actor/senderApi.h>
+#include <private/replySlot.h>
 
 SenderApi::SenderApi(std::string name) : name(std::move(name)) {}
 
 SenderApi::~SenderApi() = default;
 
+void SenderApi::post(Command command, RawData &&data, SharedSenderLink sender) {
+	post(command, static_cast<const RawData &>(data), std::move(sender));
+}
+
+PostStatus SenderApi::tryPost(Command command, const RawData &data, SharedSenderLink sender) {
+	try {
+		post(command, data, std::move(sender));
+	} catch (const MailBoxFull &) {
+		return PostStatus::FULL;
+	}
+	return PostStatus::OK;
+}
+
+void SenderApi::request(Command command, const RawData &data, SharedSenderLink replyTo) {
+	post(command, data, std::move(replyTo));
+}
+
+Reply SenderApi::ask(Command command, unsigned int timeout_in_ms) {
+	static const RawData EMPTY_DATA;
+	return ask(command, EMPTY_DATA, timeout_in_ms);
+}
+
+Reply SenderApi::ask(Command command, const RawData &data, unsigned int timeout_in_ms) {
+	const auto slot = std::make_shared<ReplySlot>();
+	Reply reply(slot, timeout_in_ms);
+	request(command, data, slot);
+	return reply;
+}
+
 const std::string &SenderApi::getName(void) const { return name; }
 
 bool SenderApi::hasName(const std::string &n) const { return 0 == name.compare(n); }
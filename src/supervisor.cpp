@@ -85,6 +85,11 @@ void Supervisor::unregisterMonitored(Supervisor &monitored) {
 	doRegistrationOperation(monitored, [this, &monitored](void) { supervisedRefs.remove(monitored.self->getName()); } );
 }
 
+SharedLink Supervisor::getSupervisorLink(void) const {
+	std::unique_lock<std::mutex> l(monitorMutex);
+	return supervisorRef.lock();
+}
+
 void Supervisor::doRegistrationOperation(Supervisor &monitored, std::function<void(void)> op) const {
 	std::lock(this->monitorMutex, monitored.monitorMutex);
 	std::lock_guard<std::mutex> l1(this->monitorMutex, std::adopt_lock);
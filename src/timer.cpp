@@ -0,0 +1,90 @@
+/* Copyright 2017 Laurent Van Begin
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE OpenSSL PROJECT ``AS IS'' AND ANY
+ * EXPRESSED OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ * PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE OpenSSL PROJECT OR
+ * ITS CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL,
+ * SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+ * NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ * HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+ * STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE)
+ * ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED
+ * OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <actor/timer.h>
+
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <chrono>
+#include <map>
+
+/* one thread for all the timers: started at the first timer and stopped at exit. */
+class TimerService {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	TimerService() : stopping(false), thread([this]() { run(); }) { }
+	~TimerService() {
+		{
+			std::unique_lock<std::mutex> l(mutex);
+			stopping = true;
+			condition.notify_one();
+		}
+		thread.join();
+	}
+
+	void add(Clock::time_point deadline, std::function<void(void)> callback) {
+		std::unique_lock<std::mutex> l(mutex);
+		const auto first = timers.emplace(deadline, std::move(callback));
+		if (timers.begin() == first)
+			condition.notify_one();
+	}
+private:
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::multimap<Clock::time_point, std::function<void(void)>> timers;
+	bool stopping;
+	std::thread thread;
+
+	void run(void) {
+		std::unique_lock<std::mutex> l(mutex);
+		while (!stopping) {
+			if (timers.empty()) {
+				condition.wait(l);
+				continue;
+			}
+			const auto first = timers.begin();
+			if (Clock::now() < first->first) {
+				condition.wait_until(l, first->first);
+				continue;
+			}
+			const auto callback = std::move(first->second);
+			timers.erase(first);
+			l.unlock();
+			callback();
+			l.lock();
+		}
+	}
+};
+
+void runAfter(unsigned int delay_in_ms, std::function<void(void)> callback) {
+	static TimerService service;
+	service.add(TimerService::Clock::now() + std::chrono::milliseconds(delay_in_ms), std::move(callback));
+}
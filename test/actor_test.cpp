@@ -31,12 +31,21 @@
 #include <actor/actor.h>
 #include <actor/rawData.h>
 #include <actor/commandMap.h>
+#include <actor/payloadSerializer.h>
+#include <actor/flatPayload.h>
 #include <actor/actorRegistry.h>
 #include <actor/link.h>
+#include <actor/coroutine.h>
+#include <actor/router.h>
+#include <actor/balancingPool.h>
 
 #include <cstdlib>
 #include <iostream>
 #include <unistd.h>
+#include <thread>
+#include <atomic>
+#include <set>
+#include <numeric>
 
 static const std::string PARAM_VALUE("Hello World");
 static const int OK_ANSWER = 0x22;
@@ -250,6 +259,59 @@ static void findActorFromOtherRegistryAndSendMessageTest() {
 	assert_eq(OK_ANSWER, link->get().code);
 }
 
+static void askActorFromOtherRegistryTest() {
+	static const uint16_t PORT1 = 4001;
+	static const uint16_t PORT2 = 4002;
+	ActorRegistry registry1(REGISTRY_NAME1, PORT1);
+	ActorRegistry registry2(REGISTRY_NAME2, PORT2);
+	registry1.addReference("localhost", PORT2);
+	const Actor a(ACTOR_NAME, testCommands().commands);
+	registry2.registerActor(a);
+	const auto actor = registry1.getActor(ACTOR_NAME);
+	assert_true(nullptr != actor.get());
+
+	const auto withData = actor->ask(OK_COMMAND_CHECK_DATA, RawData(PARAM_VALUE), 5000);
+	const auto withoutData = actor->ask(OK_COMMAND_CHECK_NO_DATA, 5000);
+	assert_eq(OK_ANSWER, withoutData.getCommand());
+	assert_eq(OK_ANSWER, withData.getCommand());
+}
+
+static void askRemoteActorWithFullMailBoxTest() {
+	static const uint16_t PORT1 = 4001;
+	static const uint16_t PORT2 = 4002;
+	static const Command BLOCKING_COMMAND = 0x5B | COMMAND_FLAG;
+	ActorRegistry registry1(REGISTRY_NAME1, PORT1);
+	ActorRegistry registry2(REGISTRY_NAME2, PORT2);
+	registry1.addReference("localhost", PORT2);
+	std::atomic<bool> running(false);
+	std::atomic<bool> released(false);
+	commandMap commands[] = {
+		{ BLOCKING_COMMAND, [&running, &released](Context &, const RawData &, const SharedSenderLink &) {
+			running = true;
+			while (!released)
+				std::this_thread::sleep_for(std::chrono::milliseconds(1));
+			return StatusCode::OK;
+		}},
+		{ OK_COMMAND, [](Context &, const RawData &, const SharedSenderLink &sender) {
+			if (nullptr != sender)
+				sender->post(OK_ANSWER);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor a(ACTOR_NAME, commands, ActorOptions(MailBoxOptions(1, OverflowPolicy::FAIL)));
+	registry2.registerActor(a);
+	const auto actor = registry1.getActor(ACTOR_NAME);
+	assert_true(nullptr != actor.get());
+
+	a.post(BLOCKING_COMMAND);
+	waitCondition([&running]() { return running.load(); });
+	a.post(OK_COMMAND);
+	assert_eq(MAILBOX_FULL, actor->ask(OK_COMMAND, 5000).getCommand());
+	released = true;
+	waitCondition([&actor]() { return OK_ANSWER == actor->ask(OK_COMMAND, 5000).getCommand(); });
+}
+
 static void findActorFromOtherRegistryAndSendWithSenderForwardToAnotherActorMessageTest() {
 	static const std::string ACTOR_NAME1(ACTOR_NAME);
 	static const std::string ACTOR_NAME2("my actor 2");
@@ -593,6 +655,20 @@ static void restartActorFailureTest() {
 	assert_true(hooks.actorStopped);
 }
 
+static void failedRestartCallsAtStopTest() {
+	for (const auto &scheduler : { SharedScheduler(), Scheduler::create(1) }) {
+		TestHooks hooks(StatusCode::OK, StatusCode::ERROR);
+		testCommands commands;
+		Actor supervisor("supervisor", CommandExecutor(), [](ErrorCode) { return ErrorReactionFactory::restartActor(); });
+		Actor supervised("supervised", commands.commands, hooks.hooks, std::make_unique<NoState>(),
+							DEFAULT_ERROR_DISPATCHER, ActorOptions(scheduler));
+		supervisor.registerActor(supervised);
+		supervised.post(EXCEPTION_THROWN_COMMAND);
+		waitCondition([&hooks]() { return hooks.actorStopped; });
+		assert_eq(1, hooks.actorRestarted);
+	}
+}
+
 static void preAndPostActionCalledTest() {
 	testCommands commands;
 	Actor actor(ACTOR_NAME, std::move(commands.executor));
@@ -650,6 +726,1150 @@ static void initStateDoneAtRestart() {
 	waitCondition([state](){ return 2 == state->isInitCalled(); });
 }
 
+static void boundedLinkFailsWhenFullTest() {
+	const auto link = Link::create("bounded", MailBoxOptions(2, OverflowPolicy::FAIL));
+	assert_true(PostStatus::OK == link->tryPost(OK_ANSWER));
+	assert_true(PostStatus::OK == link->tryPost(NOK_ANSWER));
+	assert_true(PostStatus::FULL == link->tryPost(OK_ANSWER));
+	assert_exception(MailBoxFull, link->post(OK_ANSWER));
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_true(PostStatus::OK == link->tryPost(OK_ANSWER));
+	assert_eq(2, link->size());
+}
+
+static void boundedLinkDropsNewestTest() {
+	const auto link = Link::create("bounded", MailBoxOptions(2, OverflowPolicy::DROP_NEWEST));
+	link->post(OK_ANSWER);
+	link->post(OK_ANSWER);
+	link->post(NOK_ANSWER);
+	assert_true(PostStatus::DROPPED == link->tryPost(NOK_ANSWER));
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_false(link->get(100).isValid());
+}
+
+static void boundedLinkDropsOldestTest() {
+	const auto link = Link::create("bounded", MailBoxOptions(2, OverflowPolicy::DROP_OLDEST));
+	link->post(NOK_ANSWER);
+	link->post(NOK_ANSWER);
+	link->post(OK_ANSWER);
+	assert_true(PostStatus::DROPPED == link->tryPost(OK_ANSWER));
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_false(link->get(100).isValid());
+}
+
+static void dropOldestKeepsInternalMessagesTest() {
+	const auto link = Link::create("bounded", MailBoxOptions(1, OverflowPolicy::DROP_OLDEST));
+	link->post(NOK_ANSWER);
+	link->defer([]() { return StatusCode::OK; });
+	assert_true(PostStatus::DROPPED == link->tryPost(OK_ANSWER));
+	assert_true(MessageType::DEFERRED_MESSAGE == link->get().type);
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_false(link->get(100).isValid());
+}
+
+static void boundedLinkBlocksProducerTest() {
+	static const int NB_MESSAGES = 1000;
+	const auto link = Link::create("bounded", MailBoxOptions(1, OverflowPolicy::BLOCK));
+	std::thread producer([link]() {
+		for (int i = 0; i < NB_MESSAGES; i++)
+			link->post(i);
+	});
+	for (int i = 0; i < NB_MESSAGES; i++)
+		assert_eq(i, link->get().code);
+	producer.join();
+	assert_true(PostStatus::OK == link->tryPost(OK_ANSWER));
+	assert_true(PostStatus::FULL == link->tryPost(OK_ANSWER));
+}
+
+static void actorWithBoundedMailBoxTest() {
+	static const int NB_MESSAGES = 1000;
+	const auto link = Link::create();
+	testCommands commands;
+	const Actor a(ACTOR_NAME, commands.commands, ActorOptions(MailBoxOptions(4, OverflowPolicy::BLOCK)));
+	for (int i = 0; i < NB_MESSAGES; i++)
+		a.post(OK_COMMAND, link);
+	for (int i = 0; i < NB_MESSAGES; i++)
+		assert_eq(OK_ANSWER, link->get().code);
+}
+
+static void actorWithBatchedMailBoxTest() {
+	static const int NB_MESSAGES = 1000;
+	const auto link = Link::create("replies", MailBoxOptions(MailBoxOptions::UNBOUNDED, OverflowPolicy::BLOCK, 16));
+	testCommands commands;
+	const Actor a(ACTOR_NAME, commands.commands,
+					ActorOptions(MailBoxOptions(MailBoxOptions::UNBOUNDED, OverflowPolicy::BLOCK, 16)));
+	for (int i = 0; i < NB_MESSAGES; i++)
+		a.post(OK_COMMAND, link);
+	for (int i = 0; i < NB_MESSAGES; i++)
+		assert_eq(OK_ANSWER, link->get().code);
+	assert_eq(NB_MESSAGES, commands.commandExecuted);
+}
+
+static void batchedActorStopsProcessingAfterShutdownTest() {
+	const auto link = Link::create();
+	TestHooks hooks;
+	const Actor a(ACTOR_NAME, testCommands().commands, hooks.hooks, std::make_unique<NoState>(), DEFAULT_ERROR_DISPATCHER,
+					ActorOptions(MailBoxOptions(MailBoxOptions::UNBOUNDED, OverflowPolicy::BLOCK, 16)));
+	a.post(STOP_COMMAND);
+	a.post(OK_COMMAND, link);
+	waitCondition([&hooks]() { return hooks.actorStopped; });
+	assert_false(link->get(500).isValid());
+}
+
+static void managementMessagesBypassCommandBacklogTest() {
+	static const Command MANAGEMENT_CODE = 0x55;
+	const auto link = Link::create("backlog", MailBoxOptions(2, OverflowPolicy::FAIL, 8));
+	link->post(OK_ANSWER);
+	link->post(OK_ANSWER);
+	link->post(MessageType::MANAGEMENT_MESSAGE, MANAGEMENT_CODE);
+	link->post(MessageType::ERROR_MESSAGE, MANAGEMENT_CODE);
+	assert_true(MessageType::MANAGEMENT_MESSAGE == link->get().type);
+	assert_true(MessageType::ERROR_MESSAGE == link->get().type);
+	assert_eq(OK_ANSWER, link->get().code);
+	link->post(MessageType::MANAGEMENT_MESSAGE, MANAGEMENT_CODE);
+	assert_eq(MANAGEMENT_CODE, link->get().code);
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_false(link->get(100).isValid());
+}
+
+static void linkReceivesBatchInOrderTest() {
+	const auto link = Link::create();
+	link->post({ { OK_ANSWER, RawData(PARAM_VALUE) }, { NOK_ANSWER, RawData() }, { OK_ANSWER, RawData(PARAM_VALUE) } });
+	const std::vector<PostedCommand> commands { { NOK_ANSWER, RawData(PARAM_VALUE) } };
+	link->post(commands);
+	auto m = link->get();
+	assert_eq(OK_ANSWER, m.code);
+	assert_eq(PARAM_VALUE, m.params.toString());
+	assert_eq(NOK_ANSWER, link->get().code);
+	assert_eq(OK_ANSWER, link->get().code);
+	assert_eq(NOK_ANSWER, link->get().code);
+	assert_false(link->get(100).isValid());
+}
+
+static void batchesFromConcurrentProducersAreContiguousTest() {
+	static const int NB_PRODUCERS = 4;
+	static const int NB_BATCHES = 500;
+	static const int BATCH_SIZE = 8;
+	const auto link = Link::create();
+	std::vector<std::thread> producers;
+	for (int p = 0; p < NB_PRODUCERS; p++)
+		producers.emplace_back([link, p]() {
+			std::vector<PostedCommand> batch;
+			for (int i = 0; i < BATCH_SIZE; i++)
+				batch.emplace_back(p * BATCH_SIZE + i, RawData());
+			for (int i = 0; i < NB_BATCHES; i++)
+				link->post(batch);
+		});
+	for (int i = 0; i < NB_PRODUCERS * NB_BATCHES; i++) {
+		const Command first = link->get().code;
+		assert_eq(0, first % BATCH_SIZE);
+		for (int j = 1; j < BATCH_SIZE; j++)
+			assert_eq(first + j, link->get().code);
+	}
+	for (auto &t : producers)
+		t.join();
+}
+
+static void batchLargerThanBoundedMailBoxIsRejectedTest() {
+	const auto link = Link::create("bounded", MailBoxOptions(2, OverflowPolicy::BLOCK));
+	assert_exception(MailBoxFull, link->post({ { OK_ANSWER, RawData() }, { OK_ANSWER, RawData() }, { OK_ANSWER, RawData() } }));
+	link->post({ { OK_ANSWER, RawData() }, { OK_ANSWER, RawData() } });
+	assert_eq(2, link->size());
+}
+
+static void actorReceivesBatchTest() {
+	const auto link = Link::create();
+	testCommands commands;
+	const Actor a(ACTOR_NAME, commands.commands);
+	a.post({ { OK_COMMAND, RawData() }, { OK_COMMAND_CHECK_DATA, RawData(PARAM_VALUE) }, { OK_COMMAND, RawData() } }, link);
+	for (int i = 0; i < 3; i++)
+		assert_eq(OK_ANSWER, link->get().code);
+	assert_eq(2, commands.commandExecuted);
+}
+
+static void actorPingPongWithSpinningMailBoxesTest() {
+	static const int NB_ROUND_TRIPS = 1000;
+	static const MailBoxOptions spinning(MailBoxOptions::UNBOUNDED, OverflowPolicy::BLOCK, 1, 1000);
+	const auto link = Link::create("replies", spinning);
+	testCommands commands;
+	const Actor a(ACTOR_NAME, commands.commands, ActorOptions(spinning));
+	for (int i = 0; i < NB_ROUND_TRIPS; i++) {
+		a.post(OK_COMMAND, link);
+		assert_eq(OK_ANSWER, link->get().code);
+	}
+	a.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+	assert_false(link->get(10).isValid());
+}
+
+static void pooledActorsShareWorkersTest() {
+	static const int NB_ACTORS = 200;
+	const auto scheduler = Scheduler::create(2);
+	const auto link = Link::create("replies");
+	testCommands commands;
+	std::vector<std::unique_ptr<Actor>> actors;
+	for (int i = 0; i < NB_ACTORS; i++)
+		actors.push_back(std::make_unique<Actor>(ACTOR_NAME + std::to_string(i), commands.commands, ActorOptions(scheduler)));
+	for (const auto &a : actors)
+		a->post(OK_COMMAND, link);
+	for (int i = 0; i < NB_ACTORS; i++)
+		assert_eq(OK_ANSWER, link->get(1000).code);
+	assert_eq(2u, scheduler->getNbWorkers());
+}
+
+static const Command PING_COMMAND = 0x5C | COMMAND_FLAG;
+
+/* two actors of the scheduler posting PING_COMMAND to each other until the object is destroyed. */
+class PingPong {
+public:
+	explicit PingPong(const SharedScheduler &scheduler) :
+			commands { { PING_COMMAND, [this](Context &, const RawData &, const SharedSenderLink &sender) {
+							nbPings++;
+							if (!stop)
+								sender->post(PING_COMMAND, (sender == pingLink) ? pongLink : pingLink);
+							return StatusCode::OK;
+						}},
+						{ 0, NULL } },
+			stop(false), nbPings(0), ping("ping", commands, ActorOptions(scheduler)),
+			pong("pong", commands, ActorOptions(scheduler)) {
+		pingLink = ping.getActorLinkRef();
+		pongLink = pong.getActorLinkRef();
+		ping.post(PING_COMMAND, pongLink);
+	}
+	~PingPong() { stop = true; }
+
+	uint64_t getNbPings(void) const { return nbPings; }
+private:
+	commandMap commands[2];
+	std::atomic<bool> stop;
+	std::atomic<uint64_t> nbPings;
+	SharedSenderLink pingLink;
+	SharedSenderLink pongLink;
+	const Actor ping;
+	const Actor pong;
+};
+
+static void externalPostRunsWhileActorsPingPongTest() {
+	const auto scheduler = Scheduler::create(1);
+	const PingPong pingPong(scheduler);
+	waitCondition([&pingPong]() { return 1000 < pingPong.getNbPings(); });
+	const auto link = Link::create("replies");
+	testCommands commands;
+	const Actor third("third", commands.commands, ActorOptions(scheduler));
+	third.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(2000).code);
+}
+
+static void yieldingActorRunsWhileActorsPingPongTest() {
+	static const int NB_MESSAGES = 1000;
+	const auto scheduler = Scheduler::create(1, CpuSet(), 5);
+	const PingPong pingPong(scheduler);
+	waitCondition([&pingPong]() { return 1000 < pingPong.getNbPings(); });
+	testCommands commands;
+	const Actor bulk("bulk", commands.commands, ActorOptions(scheduler));
+	for (int i = 0; i < NB_MESSAGES; i++)
+		bulk.post(OK_COMMAND);
+	waitCondition([&commands]() { return NB_MESSAGES == commands.commandExecuted; });
+	assert_true(0 < bulk.getStatistics().nbBudgetExhausted);
+}
+
+static void pooledActorRestartedBySupervisorTest() {
+	const auto scheduler = Scheduler::create(1);
+	const auto link = Link::create("replies");
+	Actor supervisor("supervisor", CommandExecutor(), ActorOptions(scheduler));
+	TestHooks hooks;
+	testCommands commands;
+	Actor supervised("supervised", commands.commands, hooks.hooks, std::make_unique<NoState>(),
+						DEFAULT_ERROR_DISPATCHER, ActorOptions(scheduler));
+	supervisor.registerActor(supervised);
+	supervised.post(EXCEPTION_THROWN_COMMAND);
+	waitCondition([&hooks]() { return 1 == hooks.actorRestarted; });
+	supervised.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+}
+
+static void pooledActorDestroyedByPooledActorTest() {
+	const auto scheduler = Scheduler::create(1);
+	const auto link = Link::create("replies");
+	TestHooks hooks;
+	std::unique_ptr<Actor> destroyed(new Actor("destroyed", CommandExecutor(), hooks.hooks, std::make_unique<NoState>(),
+												DEFAULT_ERROR_DISPATCHER, ActorOptions(scheduler)));
+	commandMap commands[] = {
+		{ OK_COMMAND, [&destroyed](Context &, const RawData &, const SharedSenderLink &sender) {
+			destroyed.reset();
+			sender->post(OK_ANSWER);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	Actor destroyer("destroyer", commands, ActorOptions(scheduler));
+	destroyer.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+	assert_true(hooks.actorStopped);
+}
+
+static void pinnedActorPlacementTest() {
+	ActorOptions options;
+	options.cpus = { 0 };
+	const Actor a(ACTOR_NAME, testCommands().commands, options);
+	assert_true(CpuSet { 0 } == a.getPlacement().cpus);
+}
+
+static void actorWithInvalidCpuSetTest() {
+	ActorOptions options;
+	options.cpus = { 1u << 20 };
+	assert_exception(InvalidCpuSet, Actor(ACTOR_NAME, testCommands().commands, options));
+}
+
+static void pooledActorPlacementIsSchedulerPlacementTest() {
+	const auto scheduler = Scheduler::create(2, CpuSet { 0 });
+	const Actor a(ACTOR_NAME, testCommands().commands, ActorOptions(scheduler));
+	assert_true(CpuSet { 0 } == a.getPlacement().cpus);
+	assert_true(CpuSet { 0 } == scheduler->getPlacement().cpus);
+}
+
+static void pooledActorYieldsAfterMessageBudgetTest() {
+	static const int NB_MESSAGES = 1000;
+	static const size_t BUDGET = 5;
+	const auto scheduler = Scheduler::create(1, CpuSet(), 10);
+	const auto link = Link::create("replies");
+	std::atomic<bool> open(false);
+	commandMap gateCommands[] = {
+		{ OK_COMMAND, [&open](Context &, const RawData &, const SharedSenderLink &) {
+			while (!open)
+				std::this_thread::yield();
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	Actor gate("gate", gateCommands, ActorOptions(scheduler));
+	testCommands bulkCommands;
+	ActorOptions bulkOptions(scheduler);
+	bulkOptions.messageBudget = BUDGET;
+	Actor bulk("bulk", bulkCommands.commands, bulkOptions);
+	int executedByBulk = -1;
+	commandMap smallCommands[] = {
+		{ OK_COMMAND, [&executedByBulk, &bulkCommands](Context &, const RawData &, const SharedSenderLink &sender) {
+			executedByBulk = bulkCommands.commandExecuted;
+			sender->post(OK_ANSWER);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	Actor small("small", smallCommands, ActorOptions(scheduler));
+
+	gate.post(OK_COMMAND);
+	for (int i = 0; i < NB_MESSAGES; i++)
+		bulk.post(OK_COMMAND);
+	small.post(OK_COMMAND, link);
+	open = true;
+	assert_eq(OK_ANSWER, link->get(1000).code);
+	assert_eq(static_cast<int>(BUDGET), executedByBulk);
+	waitCondition([&bulkCommands]() { return NB_MESSAGES == bulkCommands.commandExecuted; });
+	assert_true(NB_MESSAGES / BUDGET - 1 <= bulk.getStatistics().nbBudgetExhausted);
+	assert_true(bulk.getStatistics().nbBudgetExhausted <= scheduler->getStatistics().nbBudgetExhausted);
+}
+
+static void actorAskTest() {
+	static const Command ECHO_COMMAND = 0x55 | COMMAND_FLAG;
+	commandMap commands[] = {
+		{ ECHO_COMMAND, [](Context &, const RawData &params, const SharedSenderLink &sender) {
+			sender->post(OK_ANSWER, params);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor a(ACTOR_NAME, commands);
+	const auto reply = a.ask(ECHO_COMMAND, RawData(PARAM_VALUE), 1000);
+	assert_eq(PARAM_VALUE, reply.get().toString());
+	assert_eq(OK_ANSWER, reply.getCommand());
+	assert_true(reply.isReady());
+	assert_eq(UNKNOWN_COMMAND, a.ask(OK_COMMAND, 1000).getCommand());
+}
+
+static void askWithoutReplyTimesOutTest() {
+	const Actor a(ACTOR_NAME, testCommands().commands);
+	const auto reply = a.ask(OK_COMMAND_NO_ANSWER, 10);
+	assert_false(reply.wait());
+	assert_exception(ReplyTimeout, reply.get());
+}
+
+static void asyncStartReturnsBeforeAtStartTest() {
+	const auto link = Link::create("replies");
+	for (const auto &scheduler : { SharedScheduler(), Scheduler::create(1) }) {
+		std::atomic<bool> open(false);
+		ActorHooks hooks([&open](const Context &) {
+			while (!open)
+				std::this_thread::yield();
+			return StatusCode::OK;
+		}, DEFAULT_STOP_HOOK, DEFAULT_RESTART_HOOK);
+		ActorOptions options(scheduler);
+		options.asyncStart = true;
+		testCommands commands;
+		const Actor a(ACTOR_NAME, commands.commands, hooks, std::make_unique<NoState>(),
+						DEFAULT_ERROR_DISPATCHER, options);
+		a.post(OK_COMMAND, link);
+		open = true;
+		a.waitStarted();
+		assert_eq(OK_ANSWER, link->get(1000).code);
+	}
+}
+
+static void asyncStartFailureTest() {
+	for (const auto &scheduler : { SharedScheduler(), Scheduler::create(1) }) {
+		TestHooks hooks(StatusCode::ERROR, StatusCode::OK);
+		ActorOptions options(scheduler);
+		options.asyncStart = true;
+		const Actor a(ACTOR_NAME, CommandExecutor(), hooks.hooks, std::make_unique<NoState>(),
+						DEFAULT_ERROR_DISPATCHER, options);
+		assert_exception(ActorStartFailure, a.waitStarted());
+	}
+}
+
+static void spawnAllTest() {
+	static const size_t NB_ACTORS = 50;
+	const auto link = Link::create("replies");
+	for (const auto &scheduler : { SharedScheduler(), Scheduler::create(2) }) {
+		std::atomic<size_t> nbStarted(0);
+		const auto actors = Actor::spawnAll(NB_ACTORS, [&nbStarted](size_t i, const ActorOptions &options) {
+			ActorHooks hooks([&nbStarted](const Context &) { nbStarted++; return StatusCode::OK; },
+								DEFAULT_STOP_HOOK, DEFAULT_RESTART_HOOK);
+			return std::make_unique<Actor>(ACTOR_NAME + std::to_string(i), testCommands().commands, hooks,
+											std::make_unique<NoState>(), DEFAULT_ERROR_DISPATCHER, options);
+		}, ActorOptions(scheduler));
+		assert_eq(NB_ACTORS, actors.size());
+		assert_eq(NB_ACTORS, nbStarted.load());
+		for (const auto &a : actors)
+			a->post(OK_COMMAND_CHECK_NO_DATA, link);
+		for (size_t i = 0; i < NB_ACTORS; i++)
+			assert_eq(OK_ANSWER, link->get(1000).code);
+	}
+	assert_exception(ActorStartFailure, Actor::spawnAll(NB_ACTORS, [](size_t i, const ActorOptions &options) {
+		ActorHooks hooks([i](const Context &) { return (7 == i) ? StatusCode::ERROR : StatusCode::OK; },
+							DEFAULT_STOP_HOOK, DEFAULT_RESTART_HOOK);
+		return std::make_unique<Actor>(ACTOR_NAME, CommandExecutor(), hooks, std::make_unique<NoState>(),
+										DEFAULT_ERROR_DISPATCHER, options);
+	}));
+}
+
+static CommandExecutorFactory indexAnsweringRoutees(std::atomic<bool> &open) {
+	return [&open](size_t index) {
+		const commandMap commands[] = {
+			{ OK_COMMAND, [index](Context &, const RawData &, const SharedSenderLink &sender) {
+				sender->post(OK_ANSWER, RawData(static_cast<uint32_t>(index)));
+				return StatusCode::OK;
+			}},
+			{ OK_COMMAND_NO_ANSWER, [&open](Context &, const RawData &, const SharedSenderLink &) {
+				while (!open)
+					std::this_thread::yield();
+				return StatusCode::OK;
+			}},
+			{ 0, NULL },
+		};
+		return CommandExecutor(commands);
+	};
+}
+
+static void routerRoundRobinTest() {
+	std::atomic<bool> open(true);
+	const Router router(ACTOR_NAME, 3, indexAnsweringRoutees(open));
+	assert_eq(3u, router.getNbRoutees());
+	for (uint32_t i = 0; i < 6; i++)
+		assert_eq(i % 3, router.ask(OK_COMMAND, 1000).get().toInt());
+}
+
+static void routerLeastQueueDepthTest() {
+	std::atomic<bool> open(false);
+	const Router router(ACTOR_NAME, 3, indexAnsweringRoutees(open), RoutingPolicy::LEAST_QUEUE_DEPTH,
+						ActorOptions(Scheduler::create(2)));
+	router.getRoutee(0).post(OK_COMMAND_NO_ANSWER);
+	router.getRoutee(0).post(OK_COMMAND_NO_ANSWER);
+	for (int i = 0; i < 10; i++)
+		assert_true(0 != router.ask(OK_COMMAND, 1000).get().toInt());
+	open = true;
+}
+
+static void routerConsistentHashTest() {
+	std::atomic<bool> open(true);
+	const Router router(ACTOR_NAME, 4, indexAnsweringRoutees(open), RoutingPolicy::CONSISTENT_HASH);
+	std::set<uint32_t> used;
+	for (int i = 0; i < 20; i++) {
+		const RawData key("key " + std::to_string(i));
+		const auto routee = router.ask(OK_COMMAND, key, 1000).get().toInt();
+		assert_eq(routee, router.ask(OK_COMMAND, key, 1000).get().toInt());
+		used.insert(routee);
+	}
+	assert_true(1 < used.size());
+}
+
+static void routerFromOtherRegistryTest() {
+	static const uint16_t PORT1 = 4001;
+	static const uint16_t PORT2 = 4002;
+	ActorRegistry registry1(REGISTRY_NAME1, PORT1);
+	ActorRegistry registry2(REGISTRY_NAME2, PORT2);
+	registry1.addReference("localhost", PORT2);
+	std::atomic<bool> open(true);
+	const Router router(ACTOR_NAME, 3, indexAnsweringRoutees(open));
+	registry2.registerActor(router);
+	const auto actor = registry1.getActor(ACTOR_NAME);
+	assert_true(nullptr != actor.get());
+
+	std::set<uint32_t> used;
+	for (int i = 0; i < 3; i++)
+		used.insert(actor->ask(OK_COMMAND, 5000).get().toInt());
+	assert_eq(3u, used.size());
+}
+
+static void routerWithFullRouteeTest() {
+	static const uint16_t PORT1 = 4001;
+	static const uint16_t PORT2 = 4002;
+	ActorRegistry registry1(REGISTRY_NAME1, PORT1);
+	ActorRegistry registry2(REGISTRY_NAME2, PORT2);
+	registry1.addReference("localhost", PORT2);
+	std::atomic<bool> open(false);
+	const Router router(ACTOR_NAME, 1, indexAnsweringRoutees(open), RoutingPolicy::ROUND_ROBIN,
+						ActorOptions(MailBoxOptions(1, OverflowPolicy::BLOCK)));
+	registry2.registerActor(router);
+	const auto actor = registry1.getActor(ACTOR_NAME);
+	assert_true(nullptr != actor.get());
+	const auto routee = std::static_pointer_cast<Link>(router.getRoutee(0).getActorLinkRef());
+
+	router.post(OK_COMMAND_NO_ANSWER);
+	waitCondition([&routee]() { return 0 == routee->size(); });
+	const auto link = router.getActorLinkRef();
+	assert_true(PostStatus::OK == link->tryPost(OK_COMMAND_NO_ANSWER, RawData()));
+	assert_true(PostStatus::FULL == link->tryPost(OK_COMMAND_NO_ANSWER, RawData()));
+	assert_eq(MAILBOX_FULL, actor->ask(OK_COMMAND, 5000).getCommand());
+	open = true;
+	waitCondition([&actor]() { return OK_ANSWER == actor->ask(OK_COMMAND, 5000).getCommand(); });
+}
+
+static void balancingPoolIdleMemberPullsTest() {
+	for (const auto &scheduler : { SharedScheduler(), Scheduler::create(2) }) {
+		std::atomic<bool> open(false);
+		std::atomic<int> busy(-1);
+		const BalancingPool pool(ACTOR_NAME, 2, [&open, &busy](size_t index) {
+			const commandMap commands[] = {
+				{ OK_COMMAND, [index](Context &, const RawData &, const SharedSenderLink &sender) {
+					sender->post(OK_ANSWER, RawData(static_cast<uint32_t>(index)));
+					return StatusCode::OK;
+				}},
+				{ OK_COMMAND_NO_ANSWER, [index, &open, &busy](Context &, const RawData &, const SharedSenderLink &) {
+					busy = index;
+					while (!open)
+						std::this_thread::yield();
+					return StatusCode::OK;
+				}},
+				{ 0, NULL },
+			};
+			return CommandExecutor(commands);
+		}, ActorOptions(scheduler));
+		pool.post(OK_COMMAND_NO_ANSWER);
+		waitCondition([&busy]() { return -1 != busy; });
+		for (int i = 0; i < 10; i++)
+			assert_eq(static_cast<uint32_t>(1 - busy), pool.ask(OK_COMMAND, 1000).get().toInt());
+		open = true;
+		assert_eq(2u, pool.getNbMembers());
+	}
+}
+
+static void balancingPoolMembersSupervisedTest() {
+	const auto link = Link::create("replies");
+	Actor supervisor("supervisor");
+	const BalancingPool pool(ACTOR_NAME, 3, [](size_t) {
+		const commandMap commands[] = {
+			{ OK_COMMAND, [](Context &, const RawData &, const SharedSenderLink &sender) {
+				sender->post(OK_ANSWER);
+				return StatusCode::OK;
+			}},
+			{ EXCEPTION_THROWN_COMMAND, [](Context &, const RawData &, const SharedSenderLink &) -> StatusCode {
+				throw std::runtime_error("some problem");
+			}},
+			{ 0, NULL },
+		};
+		return CommandExecutor(commands);
+	});
+	for (size_t i = 0; i < pool.getNbMembers(); i++)
+		supervisor.registerActor(pool.getMember(i));
+	for (int i = 0; i < 6; i++)
+		pool.post(EXCEPTION_THROWN_COMMAND, link);
+	for (int i = 0; i < 10; i++)
+		pool.post(OK_COMMAND, link);
+	for (int i = 0; i < 10; i++)
+		assert_eq(OK_ANSWER, link->get(1000).code);
+}
+
+static void balancingPoolSkipsStoppedMembersTest() {
+	const BalancingPool pool(ACTOR_NAME, 4, [](size_t index) {
+		const commandMap commands[] = {
+			{ OK_COMMAND, [index](Context &, const RawData &, const SharedSenderLink &sender) {
+				sender->post(OK_ANSWER, RawData(static_cast<uint32_t>(index)));
+				return StatusCode::OK;
+			}},
+			{ 0, NULL },
+		};
+		return CommandExecutor(commands);
+	});
+	for (size_t i = 1; i < pool.getNbMembers(); i++)
+		assert_eq(1u, pool.getMember(i).shutdown(1000).nbStopped);
+	for (int i = 0; i < 10; i++)
+		assert_eq(0u, pool.ask(OK_COMMAND, 1000).get().toInt());
+}
+
+static void balancingPoolWithBoundedMembersTest() {
+	const auto link = Link::create("replies");
+	const BalancingPool pool(ACTOR_NAME, 1, [](size_t) {
+		const commandMap commands[] = {
+			{ OK_COMMAND, [](Context &, const RawData &, const SharedSenderLink &sender) {
+				sender->post(OK_ANSWER);
+				return StatusCode::OK;
+			}},
+			{ 0, NULL },
+		};
+		return CommandExecutor(commands);
+	}, ActorOptions(MailBoxOptions(1, OverflowPolicy::BLOCK)));
+	for (int i = 0; i < 10; i++)
+		pool.post(OK_COMMAND, link);
+	assert_true(PostStatus::OK == pool.getActorLinkRef()->tryPost(OK_COMMAND, RawData(), link));
+	for (int i = 0; i < 11; i++)
+		assert_eq(OK_ANSWER, link->get(1000).code);
+}
+
+static void idleActorHibernatesTest() {
+	const auto link = Link::create("replies");
+	std::atomic<int> nbHibernations(0);
+	std::atomic<int> nbWakes(0);
+	const ActorHooks hooks(DEFAULT_START_HOOK, DEFAULT_STOP_HOOK, DEFAULT_RESTART_HOOK,
+							[&nbHibernations](const Context &) { nbHibernations++; },
+							[&nbWakes](const Context &) { nbWakes++; });
+	ActorOptions options;
+	options.idleTimeout = 10;
+	testCommands commands;
+	const Actor a(ACTOR_NAME, commands.commands, hooks, std::make_unique<NoState>(), DEFAULT_ERROR_DISPATCHER,
+					options);
+	a.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+	waitCondition([&nbHibernations]() { return 1 == nbHibernations; });
+	assert_eq(0, nbWakes.load());
+
+	a.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+	assert_eq(1, nbWakes.load());
+}
+
+static void actorWakesUpWhileHibernatingTest() {
+	ActorOptions options;
+	options.idleTimeout = 1;
+	testCommands commands;
+	const Actor a(ACTOR_NAME, commands.commands, options);
+	for (int i = 0; i < 50; i++) {
+		std::this_thread::sleep_for(std::chrono::microseconds(200 * (i % 10)));
+		assert_eq(OK_ANSWER, a.ask(OK_COMMAND, 1000).getCommand());
+	}
+}
+
+static void hibernatedActorDestroyedWhileWakingTest() {
+	for (int i = 0; i < 20; i++) {
+		std::atomic<int> nbHibernations(0);
+		const ActorHooks hooks(DEFAULT_START_HOOK, DEFAULT_STOP_HOOK, DEFAULT_RESTART_HOOK,
+								[&nbHibernations](const Context &) { nbHibernations++; });
+		ActorOptions options;
+		options.idleTimeout = 1;
+		testCommands commands;
+		const Actor a(ACTOR_NAME, commands.commands, hooks, std::make_unique<NoState>(), DEFAULT_ERROR_DISPATCHER,
+						options);
+		waitCondition([&nbHibernations]() { return 1 == nbHibernations; });
+		a.post(OK_COMMAND_NO_ANSWER);
+	}
+}
+
+static void shutdownSupervisionTreeTest() {
+	testCommands commands;
+	Actor root("root");
+	Actor supervisor("supervisor");
+	Actor supervised("supervised", commands.commands);
+	const Actor other("other", commands.commands);
+	root.registerActor(supervisor);
+	supervisor.registerActor(supervised);
+
+	const auto report = root.shutdown(1000);
+	assert_eq(3u, report.nbStopped);
+	assert_true(report.stragglers.empty());
+	assert_false(supervised.ask(OK_COMMAND, 10).wait());
+	assert_eq(OK_ANSWER, other.ask(OK_COMMAND, 1000).getCommand());
+}
+
+static void shutdownAllReportsStragglersTest() {
+	static const size_t NB_ACTORS = 200;
+	std::atomic<bool> open(false);
+	std::atomic<bool> running(false);
+	commandMap blockingCommands[] = {
+		{ OK_COMMAND, [&open, &running](Context &, const RawData &, const SharedSenderLink &) {
+			running = true;
+			while (!open)
+				std::this_thread::yield();
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor blocked("blocked", blockingCommands);
+	const auto actors = Actor::spawnAll(NB_ACTORS, [](size_t, const ActorOptions &options) {
+		return std::make_unique<Actor>(ACTOR_NAME, testCommands().commands, options);
+	});
+	blocked.post(OK_COMMAND);
+	waitCondition([&running]() { return running.load(); });
+
+	const auto report = Actor::shutdownAll(100);
+	open = true;
+	assert_eq(NB_ACTORS, report.nbStopped);
+	assert_eq(1u, report.stragglers.size());
+	assert_eq(std::string("blocked"), report.stragglers[0]);
+}
+
+static void actorCreatedWhileShutdownWaitsTest() {
+	std::atomic<bool> open(false);
+	std::atomic<bool> running(false);
+	commandMap blockingCommands[] = {
+		{ OK_COMMAND, [&open, &running](Context &, const RawData &, const SharedSenderLink &) {
+			running = true;
+			while (!open)
+				std::this_thread::yield();
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor blocked("blocked", blockingCommands);
+	blocked.post(OK_COMMAND);
+	waitCondition([&running]() { return running.load(); });
+
+	std::atomic<bool> shutdownDone(false);
+	std::thread shutdown([&blocked, &shutdownDone]() {
+		blocked.shutdown(5000);
+		shutdownDone = true;
+	});
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	{
+		testCommands commands;
+		const Actor a(ACTOR_NAME, commands.commands);
+		assert_eq(OK_ANSWER, a.ask(OK_COMMAND, 1000).getCommand());
+	}
+	const bool createdDuringShutdown = !shutdownDone;
+	open = true;
+	shutdown.join();
+	assert_true(createdDuringShutdown);
+}
+
+static void actorWatchesPipeTest() {
+	static const Command READABLE_COMMAND = 0x58 | COMMAND_FLAG;
+	for (const auto &scheduler : { SharedScheduler(), Scheduler::create(1) }) {
+		const auto link = Link::create("replies");
+		int fds[2];
+		assert_eq(0, pipe(fds));
+		commandMap commands[] = {
+			{ READABLE_COMMAND, [&link](Context &, const RawData &params, const SharedSenderLink &) {
+				const IoReadiness readiness(params);
+				char c;
+				if (IO_READABLE == readiness.events && 1 == read(readiness.fd, &c, 1))
+					link->post(OK_ANSWER, RawData(std::string(1, c)));
+				return StatusCode::OK;
+			}},
+			{ 0, NULL },
+		};
+		const Actor a(ACTOR_NAME, commands, ActorOptions(scheduler));
+		a.watch(fds[0], IO_READABLE, READABLE_COMMAND);
+		assert_eq(1, write(fds[1], "a", 1));
+		assert_eq(std::string("a"), link->get(1000).params.toString());
+		assert_eq(1, write(fds[1], "b", 1));
+		assert_eq(std::string("b"), link->get(1000).params.toString());
+		a.unwatch(fds[0]);
+		assert_eq(1, write(fds[1], "c", 1));
+		assert_false(link->get(50).isValid());
+		close(fds[0]);
+		close(fds[1]);
+	}
+}
+
+static void actorWithFullMailBoxWatchesPipeTest() {
+	static const Command READABLE_COMMAND = 0x5D | COMMAND_FLAG;
+	const auto link = Link::create("replies");
+	std::atomic<bool> open(false);
+	std::atomic<bool> running(false);
+	int fds[2];
+	assert_eq(0, pipe(fds));
+	commandMap commands[] = {
+		{ OK_COMMAND, [&open, &running](Context &, const RawData &, const SharedSenderLink &) {
+			running = true;
+			while (!open)
+				std::this_thread::yield();
+			return StatusCode::OK;
+		}},
+		{ OK_COMMAND_NO_ANSWER, [](Context &, const RawData &, const SharedSenderLink &) { return StatusCode::OK; }},
+		{ READABLE_COMMAND, [&link](Context &, const RawData &params, const SharedSenderLink &) {
+			const IoReadiness readiness(params);
+			char c;
+			if (1 == read(readiness.fd, &c, 1))
+				link->post(OK_ANSWER, RawData(std::string(1, c)));
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor a(ACTOR_NAME, commands, ActorOptions(MailBoxOptions(1, OverflowPolicy::FAIL)));
+	a.post(OK_COMMAND);
+	waitCondition([&running]() { return running.load(); });
+	assert_true(PostStatus::OK == a.tryPost(OK_COMMAND_NO_ANSWER));
+	assert_true(PostStatus::FULL == a.tryPost(OK_COMMAND_NO_ANSWER));
+
+	a.watch(fds[0], IO_READABLE, READABLE_COMMAND);
+	assert_eq(1, write(fds[1], "a", 1));
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	open = true;
+	assert_eq(std::string("a"), link->get(1000).params.toString());
+	assert_eq(1, write(fds[1], "b", 1));
+	assert_eq(std::string("b"), link->get(1000).params.toString());
+	a.unwatch(fds[0]);
+	close(fds[0]);
+	close(fds[1]);
+}
+
+static void rawDataCopyOnWriteTest() {
+	const RawData original(std::string(1 << 20, 'a'));
+	RawData copy = original;
+	assert_true(copy.shares(original));
+	assert_true(copy == original);
+	copy[0] = 'b';
+	assert_false(copy.shares(original));
+	assert_eq('a', original[0]);
+	assert_eq('b', copy[0]);
+	assert_eq(original.size(), copy.size());
+}
+
+static void rawDataConstReadKeepsSharingTest() {
+	const RawData original(std::string(1 << 20, 'a'));
+	RawData copy = original;
+	const RawData &view = copy;
+	assert_eq('a', view[0]);
+	assert_eq('a', *view.begin());
+	assert_true(copy.shares(original));
+	assert_eq('a', copy.front());
+	assert_false(copy.shares(original));
+}
+
+static void rawDataSmallPayloadIsInlineTest() {
+	RawData small(42u);
+	assert_eq(RawData::INLINE_CAPACITY, small.capacity());
+	const RawData copy = small;
+	assert_false(copy.shares(small));
+	assert_eq(42u, copy.toInt());
+	for (uint8_t i = 0; i < RawData::INLINE_CAPACITY; i++)
+		small.push_back(i);
+	assert_true(RawData::INLINE_CAPACITY < small.capacity());
+	assert_eq(sizeof(uint32_t) + RawData::INLINE_CAPACITY, small.size());
+	assert_eq(RawData::INLINE_CAPACITY - 1, small[small.size() - 1]);
+	assert_eq(42u, RawData(small.begin(), small.begin() + sizeof(uint32_t)).toInt());
+}
+
+static size_t sumOfBytes(const std::vector<uint8_t> &bytes) {
+	return std::accumulate(bytes.begin(), bytes.end(), static_cast<size_t>(0));
+}
+
+static void rawDataBehavesLikeVectorTest() {
+	for (const size_t size : { static_cast<size_t>(8), 4 * RawData::INLINE_CAPACITY }) {
+		std::vector<uint8_t> expected(size, 1);
+		RawData data(size, 1);
+		const RawData shared = data;
+		expected.insert(expected.begin() + 2, { 7, 8, 9 });
+		data.insert(data.begin() + 2, { 7, 8, 9 });
+		expected.insert(expected.end(), 3, 5);
+		data.insert(data.end(), 3, 5);
+		expected.erase(expected.begin(), expected.begin() + 1);
+		data.erase(data.begin(), data.begin() + 1);
+		expected.pop_back();
+		data.pop_back();
+		assert_true(std::vector<uint8_t>(data) == expected);
+		assert_eq(expected.front(), data.front());
+		assert_eq(expected.back(), data.back());
+		assert_eq(sumOfBytes(expected), sumOfBytes(data));
+		assert_true(RawData(size, 1) == shared);
+
+		data.assign({ 1, 2, 3 });
+		data.shrink_to_fit();
+		assert_eq(RawData::INLINE_CAPACITY, data.capacity());
+		assert_true(data < RawData({ 1, 2, 4 }));
+		assert_true(data <= RawData({ 1, 2, 3 }));
+		assert_true(data > RawData({ 1, 2 }));
+		assert_true(data >= RawData({ 1, 2, 3 }));
+	}
+}
+
+static void forwardedPayloadIsNotCopiedTest() {
+	static const Command FORWARD_COMMAND = 0x59 | COMMAND_FLAG;
+	const auto link = Link::create("replies");
+	commandMap lastCommands[] = {
+		{ FORWARD_COMMAND, [&link](Context &, const RawData &params, const SharedSenderLink &) {
+			link->post(OK_ANSWER, params);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor last("last", lastCommands);
+	commandMap firstCommands[] = {
+		{ FORWARD_COMMAND, [&last](Context &, const RawData &params, const SharedSenderLink &) {
+			last.post(FORWARD_COMMAND, params);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor first("first", firstCommands);
+	const RawData payload(std::string(1 << 20, 'a'));
+	first.post(FORWARD_COMMAND, payload);
+	first.post(FORWARD_COMMAND, RawData(payload));
+	for (int i = 0; i < 2; i++)
+		assert_true(payload.shares(link->get(1000).params));
+}
+
+struct Point {
+	uint32_t x;
+	uint32_t y;
+};
+
+template<>
+struct PayloadCodec<Point> {
+	static RawData encode(const Point &p) {
+		RawData data(p.x);
+		const RawData y(p.y);
+		data.append(y.begin(), y.end());
+		return data;
+	}
+	static Point decode(const RawData &data) {
+		return Point { RawData(data.begin(), data.begin() + 4).toInt(), RawData(data.begin() + 4, data.end()).toInt() };
+	}
+};
+
+static const Command TYPED_COMMAND = 0x5A | COMMAND_FLAG;
+
+template<typename T, typename = void>
+struct IsPostedAsObject : std::false_type { };
+
+template<typename T>
+struct IsPostedAsObject<T, EnableIfTypedObject<T>> : std::true_type { };
+
+static_assert(IsPostedAsObject<Point>::value, "a class is posted as an object.");
+static_assert(IsPostedAsObject<std::unique_ptr<std::string>>::value, "a move only class is posted as an object.");
+static_assert(!IsPostedAsObject<const char (&)[6]>::value, "a string literal must not be posted as an object.");
+static_assert(!IsPostedAsObject<const char *>::value, "a pointer must not be posted as an object.");
+static_assert(!IsPostedAsObject<std::string>::value, "a string is posted as raw data.");
+
+static void typedPostTest() {
+	const auto link = Link::create("replies");
+	commandMap commands[] = {
+		{ TYPED_COMMAND, typedCommand<std::unique_ptr<std::string>>([link](Context &,
+												const std::unique_ptr<std::string> &s, const SharedSenderLink &) {
+			link->post(OK_ANSWER, *s);
+			return StatusCode::OK;
+		})},
+		{ OK_COMMAND, typedCommand<uint32_t>([link](Context &, const uint32_t &value, const SharedSenderLink &) {
+			link->post(OK_ANSWER, RawData(value + 1));
+			return StatusCode::OK;
+		})},
+		{ 0, NULL },
+	};
+	const Actor a("typed", commands);
+	a.post(TYPED_COMMAND, std::unique_ptr<std::string>(new std::string("moved")));
+	assert_eq(std::string("moved"), link->get(1000).params.toString());
+	a.post(OK_COMMAND, RawData(41u));
+	assert_eq(42u, link->get(1000).params.toInt());
+	a.post(OK_COMMAND, typedPayload(uint32_t(1)));
+	assert_eq(2u, link->get(1000).params.toInt());
+}
+
+static void typedPostToRemoteActorTest() {
+	static const uint16_t PORT1 = 4001;
+	static const uint16_t PORT2 = 4002;
+	ActorRegistry registry1(REGISTRY_NAME1, PORT1);
+	ActorRegistry registry2(REGISTRY_NAME2, PORT2);
+	registry1.addReference("localhost", PORT2);
+	const auto link = Link::create("replies");
+	commandMap commands[] = {
+		{ TYPED_COMMAND, typedCommand<Point>([link](Context &, const Point &p, const SharedSenderLink &) {
+			link->post(OK_ANSWER, RawData(p.x + p.y));
+			return StatusCode::OK;
+		})},
+		{ 0, NULL },
+	};
+	const Actor a(ACTOR_NAME, commands);
+	registry2.registerActor(a);
+	const auto actor = registry1.getActor(ACTOR_NAME);
+	assert_false(nullptr == actor.get());
+
+	actor->post(TYPED_COMMAND, Point { 1, 2 });
+	assert_eq(3u, link->get(1000).params.toInt());
+	assert_exception(std::runtime_error, actor->post(TYPED_COMMAND, std::unique_ptr<int>(new int(0))));
+}
+
+static void unserializableReplyToRemoteActorTest() {
+	static const uint16_t PORT1 = 4001;
+	static const uint16_t PORT2 = 4002;
+	ActorRegistry registry1(REGISTRY_NAME1, PORT1);
+	ActorRegistry registry2(REGISTRY_NAME2, PORT2);
+	registry1.addReference("localhost", PORT2);
+	commandMap commands[] = {
+		{ OK_COMMAND, [](Context &, const RawData &, const SharedSenderLink &sender) {
+			sender->post(OK_ANSWER, std::unique_ptr<int>(new int(0)));
+			sender->post(OK_ANSWER);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor a(ACTOR_NAME, commands);
+	registry2.registerActor(a);
+	const auto actor = registry1.getActor(ACTOR_NAME);
+	assert_false(nullptr == actor.get());
+
+	for (int i = 0; i < 2; i++)
+		assert_eq(REPLY_NOT_SERIALIZABLE, actor->ask(OK_COMMAND, 5000).getCommand());
+}
+
+static void routerConsistentHashOnObjectsTest() {
+	std::atomic<bool> open(true);
+	const Router router(ACTOR_NAME, 4, indexAnsweringRoutees(open), RoutingPolicy::CONSISTENT_HASH);
+	std::set<uint32_t> used;
+	for (uint32_t i = 0; i < 20; i++) {
+		const auto key = typedPayload(Point { i, i });
+		const auto routee = router.ask(OK_COMMAND, key, 1000).get().toInt();
+		assert_eq(routee, router.ask(OK_COMMAND, typedPayload(Point { i, i }), 1000).get().toInt());
+		used.insert(routee);
+	}
+	assert_true(1 < used.size());
+}
+
+struct Sample {
+	uint32_t id;
+	int64_t delta;
+	std::string name;
+	PAYLOAD_FIELDS(varint(id), varint(delta), name)
+};
+
+struct Batch {
+	enum class Kind : uint8_t { FIRST, SECOND };
+	Kind kind;
+	bool last;
+	int16_t fixed;
+	double ratio;
+	RawData blob;
+	std::vector<Sample> samples;
+	std::vector<std::vector<uint16_t>> nested;
+	PAYLOAD_FIELDS(kind, last, fixed, ratio, blob, samples, nested)
+};
+
+static void payloadSerializerRoundTripTest() {
+	const Batch batch { Batch::Kind::SECOND, true, -2, 0.25, RawData({ 1, 2, 3 }),
+						{ { 300, -1, "first" }, { 0, 64, std::string(100, 'x') } }, { { 1, 2 }, { }, { 65535 } } };
+	const auto data = encodePayload(batch);
+	assert_eq(data.size(), data.capacity());
+	const auto decoded = decodePayload<Batch>(data);
+	assert_true(Batch::Kind::SECOND == decoded.kind);
+	assert_true(decoded.last);
+	assert_eq(-2, decoded.fixed);
+	assert_eq(0.25, decoded.ratio);
+	assert_true(batch.blob == decoded.blob);
+	assert_eq(2u, decoded.samples.size());
+	assert_eq(300u, decoded.samples[0].id);
+	assert_eq(-1, decoded.samples[0].delta);
+	assert_eq(std::string("first"), decoded.samples[0].name);
+	assert_eq(64, decoded.samples[1].delta);
+	assert_eq(batch.samples[1].name, decoded.samples[1].name);
+	assert_true(batch.nested == decoded.nested);
+
+	/* varints: 300 takes 2 bytes, -1 takes 1 byte. */
+	assert_eq(2u + 1u + 1u + 5u, encodePayload(batch.samples[0]).size());
+	assert_exception(std::runtime_error, decodePayload<Batch>(RawData(data.begin(), data.end() - 1)));
+	assert_true(HasPayloadCodec<Batch>::value);
+}
+
+static void flatPayloadViewTest() {
+	enum { ID, NAME, SAMPLES, HEADER, MISSING, NB_FIELDS };
+	enum { SEQUENCE, NB_HEADER_FIELDS };
+	const auto header = FlatBuilder(NB_HEADER_FIELDS).set(SEQUENCE, uint64_t(1) << 40).finish();
+	const std::vector<double> samples(1000, 0.5);
+	const auto message = FlatBuilder(NB_FIELDS, 8192).set(ID, uint16_t(7)).set(NAME, std::string("telemetry"))
+										.set(SAMPLES, samples).setTable(HEADER, header).finish();
+	const RawData forwarded = message;
+	const FlatView view(forwarded);
+
+	assert_eq(NB_FIELDS, view.getNbFields());
+	assert_eq(7, view.get<uint16_t>(ID));
+	assert_eq(std::string("telemetry"), view.getString(NAME));
+	assert_eq(samples.size(), view.getVector<double>(SAMPLES).size());
+	assert_eq(0.5, view.getVector<double>(SAMPLES)[999]);
+	assert_eq(uint64_t(1) << 40, view.getTable(HEADER).get<uint64_t>(SEQUENCE));
+	assert_false(view.has(MISSING));
+	assert_eq(3u, view.get<uint32_t>(MISSING, 3));
+	assert_false(view.getTable(MISSING).has(SEQUENCE));
+	/* the fields are read in the buffer shared by the copies of the message. */
+	assert_true(message.shares(forwarded));
+	assert_true(message.data() < view.getBytes(NAME).data && view.getBytes(NAME).data < message.data() + message.size());
+
+	assert_exception(std::out_of_range, FlatBuilder(NB_FIELDS).set(NB_FIELDS, 0));
+	const RawData truncated(message.begin(), message.begin() + 64);
+	assert_exception(std::runtime_error, FlatView(truncated).getVector<double>(SAMPLES));
+}
+
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+static const Command DELAYED_ECHO_COMMAND = 0x56 | COMMAND_FLAG;
+static const Command FORWARD_COMMAND = 0x57 | COMMAND_FLAG;
+
+static void coroutineCommandDoesNotBlockActorTest() {
+	const auto link = Link::create("replies");
+	commandMap replierCommands[] = {
+		{ DELAYED_ECHO_COMMAND, coroutineCommand([](Context &, RawData params, SharedSenderLink sender) -> CommandTask {
+			co_await sleepFor(std::chrono::milliseconds(50));
+			sender->post(OK_ANSWER, params);
+			co_return StatusCode::OK;
+		})},
+		{ 0, NULL },
+	};
+	const Actor replier("replier", replierCommands);
+	commandMap commands[] = {
+		{ FORWARD_COMMAND, coroutineCommand([&replier](Context &, RawData params, SharedSenderLink sender) -> CommandTask {
+			const auto reply = co_await replier.ask(DELAYED_ECHO_COMMAND, params, 1000);
+			sender->post(NOK_ANSWER, reply.get());
+			co_return StatusCode::OK;
+		})},
+		{ OK_COMMAND, [](Context &, const RawData &, const SharedSenderLink &sender) {
+			sender->post(OK_ANSWER);
+			return StatusCode::OK;
+		}},
+		{ 0, NULL },
+	};
+	const Actor requester(ACTOR_NAME, commands);
+
+	requester.post(FORWARD_COMMAND, RawData(PARAM_VALUE), link);
+	requester.post(OK_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+	const auto forwarded = link->get(1000);
+	assert_eq(NOK_ANSWER, forwarded.code);
+	assert_eq(PARAM_VALUE, forwarded.params.toString());
+}
+
+static void coroutineCommandSeesAskTimeoutTest() {
+	const auto link = Link::create("replies");
+	const Actor silent("silent", testCommands().commands);
+	commandMap commands[] = {
+		{ FORWARD_COMMAND, coroutineCommand([&silent](Context &, RawData, SharedSenderLink sender) -> CommandTask {
+			const auto reply = co_await silent.ask(OK_COMMAND_NO_ANSWER, 10);
+			sender->post(reply.isReady() ? NOK_ANSWER : OK_ANSWER);
+			co_return StatusCode::OK;
+		})},
+		{ 0, NULL },
+	};
+	const Actor requester(ACTOR_NAME, commands);
+	requester.post(FORWARD_COMMAND, link);
+	assert_eq(OK_ANSWER, link->get(1000).code);
+}
+#endif
+
 int main() {
 	static const _test suite[] = {
 			TEST(actorStoppedAtDeleteTest),
@@ -666,6 +1886,8 @@ int main() {
 			TEST(registeryAddActorFindItBackAndSendMessageTest),
 			TEST(registeryFindUnknownActorTest),
 			TEST(findActorFromOtherRegistryAndSendMessageTest),
+			TEST(askActorFromOtherRegistryTest),
+			TEST(askRemoteActorWithFullMailBoxTest),
 			TEST(findActorFromOtherRegistryAndSendWithSenderForwardToAnotherActorMessageTest),
 			TEST(findActorFromOtherRegistryAndSendCommandWithParamsTest),
 			TEST(findUnknownActorInMultipleRegistryTest),
@@ -687,12 +1909,73 @@ int main() {
 			TEST(supervisorHasDifferentStrategyDependingOnErrorTest),
 			TEST(startActorFailureTest),
 			TEST(restartActorFailureTest),
+			TEST(failedRestartCallsAtStopTest),
 			TEST(preAndPostActionCalledTest),
 			TEST(preActionFailsTest),
 			TEST(commandFailsAndPostActionCalledTest),
 			TEST(commandFailsWithExceptionAndPostActionCalledTest),
 			TEST(initStateDoneAtStart),
 			TEST(initStateDoneAtRestart),
+			TEST(boundedLinkFailsWhenFullTest),
+			TEST(boundedLinkDropsNewestTest),
+			TEST(boundedLinkDropsOldestTest),
+			TEST(dropOldestKeepsInternalMessagesTest),
+			TEST(boundedLinkBlocksProducerTest),
+			TEST(actorWithBoundedMailBoxTest),
+			TEST(actorWithBatchedMailBoxTest),
+			TEST(batchedActorStopsProcessingAfterShutdownTest),
+			TEST(managementMessagesBypassCommandBacklogTest),
+			TEST(linkReceivesBatchInOrderTest),
+			TEST(batchesFromConcurrentProducersAreContiguousTest),
+			TEST(batchLargerThanBoundedMailBoxIsRejectedTest),
+			TEST(actorReceivesBatchTest),
+			TEST(actorPingPongWithSpinningMailBoxesTest),
+			TEST(pooledActorsShareWorkersTest),
+			TEST(externalPostRunsWhileActorsPingPongTest),
+			TEST(yieldingActorRunsWhileActorsPingPongTest),
+			TEST(pooledActorRestartedBySupervisorTest),
+			TEST(pooledActorDestroyedByPooledActorTest),
+			TEST(pinnedActorPlacementTest),
+			TEST(actorWithInvalidCpuSetTest),
+			TEST(pooledActorPlacementIsSchedulerPlacementTest),
+			TEST(pooledActorYieldsAfterMessageBudgetTest),
+			TEST(actorAskTest),
+			TEST(askWithoutReplyTimesOutTest),
+			TEST(asyncStartReturnsBeforeAtStartTest),
+			TEST(asyncStartFailureTest),
+			TEST(spawnAllTest),
+			TEST(routerRoundRobinTest),
+			TEST(routerLeastQueueDepthTest),
+			TEST(routerConsistentHashTest),
+			TEST(routerFromOtherRegistryTest),
+			TEST(routerWithFullRouteeTest),
+			TEST(balancingPoolIdleMemberPullsTest),
+			TEST(balancingPoolMembersSupervisedTest),
+			TEST(balancingPoolSkipsStoppedMembersTest),
+			TEST(balancingPoolWithBoundedMembersTest),
+			TEST(idleActorHibernatesTest),
+			TEST(actorWakesUpWhileHibernatingTest),
+			TEST(hibernatedActorDestroyedWhileWakingTest),
+			TEST(shutdownSupervisionTreeTest),
+			TEST(shutdownAllReportsStragglersTest),
+			TEST(actorCreatedWhileShutdownWaitsTest),
+			TEST(actorWatchesPipeTest),
+			TEST(actorWithFullMailBoxWatchesPipeTest),
+			TEST(rawDataCopyOnWriteTest),
+			TEST(rawDataConstReadKeepsSharingTest),
+			TEST(rawDataSmallPayloadIsInlineTest),
+			TEST(rawDataBehavesLikeVectorTest),
+			TEST(forwardedPayloadIsNotCopiedTest),
+			TEST(typedPostTest),
+			TEST(typedPostToRemoteActorTest),
+			TEST(unserializableReplyToRemoteActorTest),
+			TEST(routerConsistentHashOnObjectsTest),
+			TEST(payloadSerializerRoundTripTest),
+			TEST(flatPayloadViewTest),
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+			TEST(coroutineCommandDoesNotBlockActorTest),
+			TEST(coroutineCommandSeesAskTimeoutTest),
+#endif
 	};
 
 	const auto nbFailure = runTest(suite);
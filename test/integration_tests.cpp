@@ -41,10 +41,29 @@
 #include <private/serverSocket.h>
 #include <private/executor.h>
 #include <private/exception.h>
+#include <private/mailBox.h>
+#include <private/workStealingDeque.h>
+#include <private/cpuAffinity.h>
 
 #include <cstdlib>
+#include <atomic>
+#include <new>
 #include <iostream>
 #include <unistd.h>
+#include <sched.h>
+
+static std::atomic<size_t> nbAllocations { 0 };
+
+void *operator new(size_t size) {
+	nbAllocations++;
+	const auto ptr = malloc(size);
+	if (nullptr == ptr)
+		throw std::bad_alloc();
+	return ptr;
+}
+
+void operator delete(void *ptr) noexcept { free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { free(ptr); }
 
 static const std::string PARAM_VALUE("Hello World");
 static const int OK_ANSWER = 0x22;
@@ -108,6 +127,14 @@ static Connection openOneConnection(uint16_t port) {
 	}
 }
 
+static Connection acceptOneConnection(uint16_t port) {
+	while (true) {
+		try {
+			return ServerSocket::getConnection(port);
+		} catch (ConnectionTimeout &e) { }
+	}
+}
+
 static void actorCommandHasReservedCodeTest(void) {
 	static const uint32_t wrongCommand = 0xaa;
 	static const commandMap commands[] = {
@@ -129,6 +156,22 @@ static void proxyTest(void) {
 	t.join();
 }
 
+static void unansweredRequestsAreForgottenTest(void) {
+	static const uint16_t PORT = 4012;
+	static const int NB_REQUESTS = 1000;
+	const auto neverAnswering = Link::create("sink");
+	std::thread t([neverAnswering]() {
+		const ProxyServer server(neverAnswering, acceptOneConnection(PORT), []() { },
+									[](std::string) { return SharedSenderLink(); });
+	});
+	ProxyClient client("client name", openOneConnection(PORT));
+	for (int i = 0; i < NB_REQUESTS; i++)
+		client.ask(OK_COMMAND, 1);
+	assert_true(client.getNbPendingRequests() <= 64);
+	client.post(InternalCommands::SHUTDOWN);
+	t.join();
+}
+
 static void registryConnectTest(void) {
 	static const uint16_t PORT = 4001;
 	const ActorRegistry registry(REGISTRY_NAME1, PORT);
@@ -142,6 +185,116 @@ static void executorTest() {
 	link->post(MessageType::COMMAND_MESSAGE, InternalCommands::SHUTDOWN);
 }
 
+static void mailBoxMultipleProducersTest() {
+	static const int NB_PRODUCERS = 4;
+	static const int NB_MESSAGES = 10000;
+	MailBox<int> mailBox(MailBoxOptions(), []() { return -1; });
+	std::vector<std::thread> producers;
+	for (int p = 0; p < NB_PRODUCERS; p++)
+		producers.emplace_back([&mailBox, p]() {
+			for (int i = 0; i < NB_MESSAGES; i++)
+				mailBox.post(p * NB_MESSAGES + i);
+		});
+	std::vector<int> lastReceived(NB_PRODUCERS, -1);
+	for (int i = 0; i < NB_PRODUCERS * NB_MESSAGES; i++) {
+		const auto value = mailBox.get();
+		const auto producer = value / NB_MESSAGES;
+		assert_true(lastReceived[producer] < value % NB_MESSAGES);
+		lastReceived[producer] = value % NB_MESSAGES;
+	}
+	for (auto &t : producers)
+		t.join();
+	assert_eq(-1, mailBox.get(10));
+}
+
+static void nodeReleasedAfterThreadCacheTest() {
+	std::thread([]() {
+		/* constructed before the node cache of the thread: destroyed after it. */
+		thread_local std::unique_ptr<MailBox<int>> mailBox;
+		mailBox.reset(new MailBox<int>());
+		mailBox->post(1);
+		mailBox->post(2);
+	}).join();
+}
+
+static void cpuSetCheckedAgainstAffinityMaskTest() {
+	cpu_set_t allowed;
+	assert_eq(0, sched_getaffinity(0, sizeof(allowed), &allowed));
+	CpuSet cpus;
+	unsigned int outside = CPU_SETSIZE;
+	for (unsigned int cpu = 0; cpu < static_cast<unsigned int>(CPU_SETSIZE); cpu++) {
+		if (CPU_ISSET(cpu, &allowed))
+			cpus.insert(cpu);
+		else if (CPU_SETSIZE == outside)
+			outside = cpu;
+	}
+	checkCpuSet(cpus);
+	assert_exception(InvalidCpuSet, checkCpuSet(CpuSet { outside }));
+}
+
+static void workStealingDequeTakesEachElementOnceTest() {
+	static const int NB_THIEVES = 3;
+	static const int NB_ELEMENTS = 100000;
+	WorkStealingDeque<int> deque(2);
+	std::vector<std::atomic<int>> taken(NB_ELEMENTS);
+	std::atomic<bool> done(false);
+	std::vector<std::thread> thieves;
+	for (int i = 0; i < NB_THIEVES; i++)
+		thieves.emplace_back([&deque, &taken, &done]() {
+			int v;
+			while (!done || !deque.empty()) {
+				if (deque.steal(v))
+					taken[v]++;
+			}
+		});
+	int v;
+	for (int i = 0; i < NB_ELEMENTS; i++) {
+		deque.push(i);
+		if (0 == i % 3 && deque.pop(v))
+			taken[v]++;
+	}
+	while (deque.pop(v))
+		taken[v]++;
+	done = true;
+	for (auto &t : thieves)
+		t.join();
+	for (const auto &n : taken)
+		assert_eq(1, n.load());
+}
+
+static void linkPostAndGetDoNotAllocateTest() {
+	static const int NB_MESSAGES = 10000;
+	const auto link = Link::create();
+	const auto postAndGet = [&link]() {
+		for (int i = 0; i < NB_MESSAGES; i++) {
+			link->post(OK_COMMAND);
+			link->get();
+		}
+	};
+	postAndGet();
+	const size_t nbAllocationsBefore = nbAllocations;
+	postAndGet();
+	const size_t nbAllocationsAfter = nbAllocations;
+	assert_eq(nbAllocationsBefore, nbAllocationsAfter);
+}
+
+static void linkPostAndGetFromOtherThreadDoNotAllocateTest() {
+	static const int NB_MESSAGES = 100000;
+	const auto link = Link::create("bounded", MailBoxOptions(256, OverflowPolicy::BLOCK, 16));
+	std::thread producer([link]() {
+		for (int i = 0; i < 2 * NB_MESSAGES; i++)
+			link->post(OK_COMMAND);
+	});
+	for (int i = 0; i < NB_MESSAGES; i++)
+		link->get();
+	const size_t nbAllocationsBefore = nbAllocations;
+	for (int i = 0; i < NB_MESSAGES; i++)
+		link->get();
+	const size_t nbAllocationsAfter = nbAllocations;
+	producer.join();
+	assert_eq(nbAllocationsBefore, nbAllocationsAfter);
+}
+
 static void serializationTest() {
 	static const uint32_t EXPECTED_VALUE = 0x11223344;
 
@@ -267,8 +420,15 @@ int main() {
 	static const _test suite[] = {
 		TEST(actorCommandHasReservedCodeTest),
 		TEST(proxyTest),
+		TEST(unansweredRequestsAreForgottenTest),
 		TEST(registryConnectTest),
 		TEST(executorTest),
+		TEST(mailBoxMultipleProducersTest),
+		TEST(nodeReleasedAfterThreadCacheTest),
+		TEST(cpuSetCheckedAgainstAffinityMaskTest),
+		TEST(workStealingDequeTakesEachElementOnceTest),
+		TEST(linkPostAndGetDoNotAllocateTest),
+		TEST(linkPostAndGetFromOtherThreadDoNotAllocateTest),
 		TEST(serializationTest),
 		TEST(connectionClosedByWriterTest),
 		TEST(connectionClosedByWriterMultipleTimesTest),